@@ -0,0 +1,145 @@
+// Compares slowlib_fbig limb sizes.
+// Built once per SLOWLIBS_FBIG_PART_BITS, see meson.build
+
+#include <stdio.h>
+#include <time.h>
+#include "slowlibs/fixed_bigint.h"
+
+static double now_ms(void)
+{
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static uint64_t rng = 0x9e3779b97f4a7c15;
+
+static void fill(slowlib_fbig_part* p, size_t np)
+{
+  size_t i;
+  for (i = 0; i < np * slowlib_fbig_part_sz; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    ((uint8_t*)p)[i] = (uint8_t)rng;
+  }
+}
+
+static volatile slowlib_fbig_part sink;
+
+#define BENCH(name, iters, ...)                                \
+  do {                                                         \
+    double _start = now_ms(), _ms;                             \
+    for (long _it = 0; _it < (iters); _it++) {                 \
+      __VA_ARGS__;                                             \
+    }                                                          \
+    _ms = now_ms() - _start;                                   \
+    printf("%2u-bit limbs  %-18s %10.1f ns/op\n",              \
+           (unsigned)SLOWLIBS_FBIG_PART_BITS, name,            \
+           _ms * 1e6 / (iters));                               \
+  } while (0)
+
+int main(void)
+{
+  slowlib_fbig_var(256, a256);
+  slowlib_fbig_var(256, b256);
+  slowlib_fbig_var(512, p512);
+  slowlib_fbig_var(2048, a2048);
+  slowlib_fbig_var(2048, b2048);
+  slowlib_fbig_var(4096, p4096);
+  slowlib_fbig_var(264, p264);
+  slowlib_fbig_const(136, P,
+                     {slowlib_fbig_const_part_u64(0xfffffffffffffffb),
+                      slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                      slowlib_fbig_const_part_u64(0x3)});
+
+  fill(a256, slowlib_fbig_np(a256));
+  fill(b256, slowlib_fbig_np(b256));
+  fill(a2048, slowlib_fbig_np(a2048));
+  fill(b2048, slowlib_fbig_np(b2048));
+  fill(p264, slowlib_fbig_np(p264));
+
+  BENCH("mul 256x256", 1000000, {
+    slowlib_fbig_mul(p512, a256, b256);
+    a256[0] ^= p512[3];
+    sink = p512[0];
+  });
+
+  BENCH("mul 2048x2048", 20000, {
+    slowlib_fbig_mul(p4096, a2048, b2048);
+    a2048[0] ^= p4096[7];
+    sink = p4096[0];
+  });
+
+  BENCH("sqr 2048", 20000, {
+    slowlib_fbig_sqr(p4096, a2048);
+    a2048[0] ^= p4096[7];
+    sink = p4096[0];
+  });
+
+  BENCH("umod 264 % 136", 20000, {
+    slowlib_fbig_umod(p264, p264, P);
+    p264[slowlib_fbig_np(p264) - 1] ^= (slowlib_fbig_part)_it;
+    sink = p264[0];
+  });
+
+  {
+    slowlib_fbig_barrett_ctx(136, ctx);
+    slowlib_fbig_var(136, r);
+    slowlib_fbig_barrett_init(ctx, P);
+    BENCH("barrett 264 % 136", 1000000, {
+      slowlib_fbig_barrett(r, p264, ctx);
+      p264[0] ^= r[0];
+      sink = r[0];
+    });
+  }
+
+  {
+    slowlib_fbig_var(136, r);
+    BENCH("reduce_pm 2^130-5", 1000000, {
+      slowlib_fbig_reduce_pm(r, p264, 130, 5);
+      p264[0] ^= r[0];
+      sink = r[0];
+    });
+  }
+
+  {
+    slowlib_fbig_mont_ctx(2048, ctx);
+    b2048[0] |= 1;
+    slowlib_fbig_mont_init(ctx, b2048);
+    slowlib_fbig_umod(a2048, a2048, b2048);
+    BENCH("mont_mul 2048", 20000, {
+      slowlib_fbig_mont_mul(a2048, a2048, a2048, ctx);
+      sink = a2048[0];
+    });
+  }
+
+  /* per number, to compare with the single-number rows above */
+  {
+    slowlib_fbig_batch_var(256, ba, 1);
+    slowlib_fbig_batch_var(256, bb, 1);
+    slowlib_fbig_batch_var(512, bp, 1);
+    fill(&ba[0][0][0], slowlib_fbig_batch_np(ba) * SLOWLIBS_FBIG_BATCH_LANES);
+    fill(&bb[0][0][0], slowlib_fbig_batch_np(bb) * SLOWLIBS_FBIG_BATCH_LANES);
+    BENCH("batch mul 256x256", 1000000 / SLOWLIBS_FBIG_BATCH_LANES, {
+      slowlib_fbig_batch_mul(bp, ba, bb, 1);
+      ba[0][0][0] ^= bp[0][3][0];
+      sink = bp[0][0][0];
+    });
+    printf("  (%u numbers per op)\n", (unsigned)SLOWLIBS_FBIG_BATCH_LANES);
+  }
+
+  {
+    slowlib_fbig_mont_ctx(2048, ctx);
+    slowlib_fbig_batch_var(2048, ba, 1);
+    size_t i;
+    slowlib_fbig_mont_init(ctx, b2048);
+    for (i = 0; i < SLOWLIBS_FBIG_BATCH_LANES; i++)
+      slowlib_fbig_batch_set(ba, i, a2048);
+    BENCH("batch mont_mul 2048", 20000 / SLOWLIBS_FBIG_BATCH_LANES, {
+      slowlib_fbig_batch_mont_mul(ba, ba, ba, ctx, 1);
+      sink = ba[0][0][0];
+    });
+    printf("  (%u numbers per op)\n", (unsigned)SLOWLIBS_FBIG_BATCH_LANES);
+  }
+
+  return 0;
+}
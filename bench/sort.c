@@ -0,0 +1,75 @@
+// sorting 32 bit ints: qsort vs slowsort introsort vs slowsort radix sort.
+// usage: sort-bench [max elements]   (default 1e7; 1e8 needs 800 MB)
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowsort.h"
+
+#define INT_LESS(a, b) ((a) < (b))
+#define INT_KEY(x) SLOWSORT_KEY_I32(x)
+
+SLOWSORT_Header(int_asc, int);
+SLOWSORT_Impl(int_asc, int, INT_LESS);
+SLOWSORT_RadixHeader(int_asc, int);
+SLOWSORT_RadixImpl(int_asc, int, INT_KEY, 4);
+
+static double now_ms(void)
+{
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+static int cmp_int(void const* a, void const* b)
+{
+  int x = *(int const*)a, y = *(int const*)b;
+  return (x > y) - (x < y);
+}
+
+static void fill(int* data, long n)
+{
+  unsigned long rng = 1;
+  long i;
+  for (i = 0; i < n; i++) {
+    rng = rng * 6364136223846793005UL + 1442695040888963407UL;
+    data[i] = (int)(rng >> 32);
+  }
+}
+
+int main(int argc, char** argv)
+{
+  long max = argc > 1 ? atol(argv[1]) : 10000000L;
+  int *data = (int*)malloc(sizeof(int) * max),
+      *scratch = (int*)malloc(sizeof(int) * max);
+  double start, ms[3];
+  long n;
+
+  if (!data || !scratch) {
+    printf("out of memory\n");
+    return 1;
+  }
+
+  for (n = 1000; n <= max; n *= 10) {
+    fill(data, n);
+    start = now_ms();
+    qsort(data, n, sizeof(int), cmp_int);
+    ms[0] = now_ms() - start;
+
+    fill(data, n);
+    start = now_ms();
+    F(SLOWARR__SO, int_asc, sort)(data, n);
+    ms[1] = now_ms() - start;
+
+    fill(data, n);
+    start = now_ms();
+    F(SLOWARR__SO, int_asc, radixSort)(data, scratch, n);
+    ms[2] = now_ms() - start;
+
+    printf("%10ld ints  qsort %9.2f ms  sort %9.2f ms  radixSort %9.2f ms\n", n,
+           ms[0], ms[1], ms[2]);
+  }
+
+  free(data);
+  free(scratch);
+  return 0;
+}
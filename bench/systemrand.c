@@ -0,0 +1,35 @@
+// Cost of small slowcrypt_systemrand() calls, like generating tokens
+
+#include <stdio.h>
+#include <time.h>
+#include "slowlibs/systemrand.h"
+
+static double now_ms(void)
+{
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+  static unsigned char big[1 << 20];
+  unsigned char buf[32];
+  double start, ms;
+  long i, iters = 200000;
+
+  start = now_ms();
+  for (i = 0; i < iters; i++)
+    if (slowcrypt_systemrand(buf, sizeof(buf), 0))
+      return 1;
+  ms = now_ms() - start;
+  printf("32 bytes   %10.1f ns/call\n", ms * 1e6 / iters);
+
+  iters = 100;
+  start = now_ms();
+  for (i = 0; i < iters; i++)
+    if (slowcrypt_systemrand(big, sizeof(big), 0))
+      return 1;
+  ms = now_ms() - start;
+  printf("1 MiB      %10.1f MiB/s\n", iters / (ms / 1000.0));
+
+  return 0;
+}
@@ -0,0 +1,34 @@
+// X25519 scalar multiplications per second.
+// Built for both field implementations, see meson.build
+
+#include <stdio.h>
+#include <time.h>
+#define SLOWCRYPT_X25519_IMPL
+#include "slowlibs/x25519.h"
+
+static double now_ms(void)
+{
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+int main(void)
+{
+  uint8_t k[32] = {9}, u[32] = {9}, out[32];
+  double start, ms;
+  long n = 0;
+  int i;
+
+  start = now_ms();
+  do {
+    for (i = 0; i < 100; i++) {
+      slowcrypt_x25519(out, k, u);
+      k[n % 32] ^= out[0];
+      n++;
+    }
+    ms = now_ms() - start;
+  } while (ms < 1000);
+
+  printf("x25519 (%d limbs)  %8.0f ladders/s  %6.1f us/ladder\n",
+         SLOWCRYPT_GF25519_LIMBS, n * 1000.0 / ms, ms * 1000.0 / n);
+  return 0;
+}
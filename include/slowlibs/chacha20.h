@@ -123,6 +123,17 @@ void slowcrypt_hchacha(slowcrypt_chacha20* state,
                        uint8_t hash[32],
                        int rounds);
 
+/*
+ * Run 8 independent HChaCha instances at once, using SIMD if available
+ * (selected at runtime).
+ *
+ * Same output as calling slowcrypt_hchacha() for each lane.
+ */
+void slowcrypt_hchacha_x8(uint8_t hash[8][32],
+                          uint8_t const key[8][32],
+                          uint8_t const nonce[8][16],
+                          int rounds);
+
 /* call this to zero out memory */
 void slowcrypt_chacha20_deinit(slowcrypt_chacha20* state);
 
@@ -185,6 +196,54 @@ void slowcrypt_kchacha(uint8_t out[32],
                        unsigned data_len,
                        int rounds);
 
+/*
+ * Run KChaCha on `n` independent messages, 8 at a time with
+ * slowcrypt_hchacha_x8(). Message lengths may differ, but messages of
+ * similar lengths in groups of 8 are the fastest.
+ *
+ * Same output as calling slowcrypt_kchacha() for each message.
+ */
+void slowcrypt_kchacha_many(uint8_t out[][32],
+                            uint8_t const protocol_constant[16],
+                            uint8_t const* const data[],
+                            unsigned const data_len[],
+                            unsigned n,
+                            int rounds);
+
+/*
+ * Incremental KChaCha state. Produces the same output as slowcrypt_kchacha(),
+ * but data can be absorbed in arbitrary pieces.
+ *
+ * Usage example:
+ *     slowcrypt_kchacha_ctx ctx;
+ *     slowcrypt_kchacha_init(&ctx, protocol_constant, 20);
+ *     while have data {
+ *       slowcrypt_kchacha_update(&ctx, data, data_len);
+ *     }
+ *     slowcrypt_kchacha_final(&ctx, hash);
+ */
+typedef struct
+{
+  slowcrypt_chacha20 cstate;
+  uint8_t state[32];
+  uint8_t chunk[32];
+  uint8_t protocol_constant[16];
+  unsigned chunk_len;
+  int rounds;
+} slowcrypt_kchacha_ctx;
+
+/* see slowcrypt_kchacha() for the parameters */
+void slowcrypt_kchacha_init(slowcrypt_kchacha_ctx* ctx,
+                            uint8_t const protocol_constant[16],
+                            int rounds);
+
+void slowcrypt_kchacha_update(slowcrypt_kchacha_ctx* ctx,
+                              uint8_t const data[],
+                              unsigned long data_len);
+
+/* also zeroizes the context */
+void slowcrypt_kchacha_final(slowcrypt_kchacha_ctx* ctx, uint8_t out[32]);
+
 /**
  *
  * Returns:
@@ -200,6 +259,197 @@ int slowcrypt_balloon_kchacha(uint8_t out[32],
                               unsigned balloon_rounds,
                               unsigned kchacha_rounds);
 
+/*
+ * Streaming variant of slowcrypt_balloon_kchacha(), for when the password is
+ * not available as one contiguous buffer.
+ *
+ * Usage example:
+ *     slowcrypt_kchacha_ctx pw;
+ *     slowcrypt_balloon_kchacha_init(&pw, protocol_constant, kchacha_rounds);
+ *     while have password data {
+ *       slowcrypt_kchacha_update(&pw, data, data_len);
+ *     }
+ *     slowcrypt_balloon_kchacha_final(out, &pw, salt, salt_len, buffer_size,
+ *                                     balloon_rounds);
+ */
+void slowcrypt_balloon_kchacha_init(slowcrypt_kchacha_ctx* pw,
+                                    uint8_t const protocol_constant[16],
+                                    unsigned kchacha_rounds);
+
+/*
+ * Also zeroizes `pw`, even on failure.
+ *
+ * Returns:
+ * - 0 on success
+ */
+int slowcrypt_balloon_kchacha_final(uint8_t out[32],
+                                    slowcrypt_kchacha_ctx* pw,
+                                    uint8_t const salt[],
+                                    unsigned salt_len,
+                                    unsigned buffer_size,
+                                    unsigned balloon_rounds);
+
+typedef enum
+{
+  /* back the buffer with (transparent) huge pages, if the platform has them */
+  SLOWCRYPT_BALLOON__HUGE_PAGES = 1 << 0,
+} slowcrypt_balloon_kchacha_flags;
+
+/*
+ * Reusable Balloon-KChaCha workspace, for running many hashes with the same
+ * parameters (ex: proof-of-work verification).
+ *
+ * Running a hash with a context does not allocate, and the salt-dependent
+ * part of the pseudo-random block selection messages is only built once
+ * per salt.
+ *
+ * Usage example:
+ *     slowcrypt_balloon_kchacha_ctx ctx;
+ *     if (slowcrypt_balloon_kchacha_ctx_init(&ctx, protocol_constant,
+ *                                            buffer_size, balloon_rounds,
+ *                                            kchacha_rounds, 0))
+ *       oom
+ *     if (slowcrypt_balloon_kchacha_ctx_salt(&ctx, salt, salt_len))
+ *       oom
+ *
+ *     for each password {
+ *       slowcrypt_balloon_kchacha_ctx_run(&ctx, out, password, password_len);
+ *     }
+ *
+ *     slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+ *
+ * Do not access the fields directly.
+ */
+typedef struct
+{
+  uint8_t protocol_constant[16];
+  int kchacha_rounds;
+  unsigned buffer_size; /* in 32-byte blocks */
+  unsigned balloon_rounds;
+
+  uint8_t* buf;
+  unsigned long buf_mapped_len; /* zero if allocated with malloc */
+
+  /* u32(cnt) || salt || u32(t) || u32(m) || u32(i) */
+  uint8_t* sel;
+  unsigned salt_len, salt_cap;
+} slowcrypt_balloon_kchacha_ctx;
+
+/*
+ * Returns:
+ * - 0 on success
+ */
+int slowcrypt_balloon_kchacha_ctx_init(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t const protocol_constant[16],
+                                       unsigned buffer_size,
+                                       unsigned balloon_rounds,
+                                       unsigned kchacha_rounds,
+                                       slowcrypt_balloon_kchacha_flags flags);
+
+/*
+ * Set the salt used by the following runs.
+ * Only allocates if the salt is longer than all previous salts.
+ *
+ * Returns:
+ * - 0 on success
+ */
+int slowcrypt_balloon_kchacha_ctx_salt(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t const salt[],
+                                       unsigned salt_len);
+
+/* same output as slowcrypt_balloon_kchacha(). Requires a salt to be set. */
+void slowcrypt_balloon_kchacha_ctx_run(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t out[32],
+                                       uint8_t const password[],
+                                       unsigned password_len);
+
+/*
+ * Streaming variant of slowcrypt_balloon_kchacha_ctx_run().
+ * `pw` has to be set up with slowcrypt_balloon_kchacha_init(),
+ * with the same protocol constant and rounds as the context.
+ *
+ * Also zeroizes `pw`.
+ */
+void slowcrypt_balloon_kchacha_ctx_final(slowcrypt_balloon_kchacha_ctx* ctx,
+                                         uint8_t out[32],
+                                         slowcrypt_kchacha_ctx* pw);
+
+/* zeroizes and frees the workspace */
+void slowcrypt_balloon_kchacha_ctx_deinit(slowcrypt_balloon_kchacha_ctx* ctx);
+
+typedef struct
+{
+  unsigned buffer_size;
+  unsigned balloon_rounds;
+  unsigned kchacha_rounds;
+
+  /* measured on this machine, single-threaded */
+  double ms_per_hash;
+  double hashes_per_sec;
+} slowcrypt_balloon_kchacha_params;
+
+/*
+ * Benchmark this machine, and search for the strongest Balloon-KChaCha
+ * parameters, where one hash takes at most `target_ms` milliseconds and uses
+ * at most `max_mem` bytes.
+ *
+ * The number of KChaCha rounds is NOT searched, as it is a security decision:
+ * pass the rounds you want to use.
+ * Memory is maximized first, and left over time is spent on balloon rounds.
+ *
+ * Returns:
+ * - 0 on success
+ * - 1 out of memory
+ * - 2 the budget is too small for any reasonable parameters
+ */
+int slowcrypt_balloon_kchacha_calibrate(slowcrypt_balloon_kchacha_params* out,
+                                        unsigned target_ms,
+                                        unsigned long max_mem,
+                                        unsigned kchacha_rounds);
+
+/*
+ * Balloon-M style parallel Balloon-KChaCha (see /doc/cacha20.md)
+ *
+ * Runs `lanes` independent balloon lanes, each using `buffer_size` bytes,
+ * on separate threads (if the platform has threads),
+ * and combines their outputs with KChaCha.
+ * Total memory usage is `lanes * buffer_size`.
+ *
+ * The output is NOT the same as slowcrypt_balloon_kchacha(), even with one lane.
+ *
+ * Returns:
+ * - 0 on success
+ * - 1 out of memory, or `lanes` is too large to allocate
+ */
+int slowcrypt_balloon_kchacha_parallel(uint8_t out[32],
+                                       uint8_t const protocol_constant[16],
+                                       uint8_t const password[],
+                                       unsigned password_len,
+                                       uint8_t const salt[],
+                                       unsigned salt_len,
+                                       unsigned buffer_size,
+                                       unsigned balloon_rounds,
+                                       unsigned kchacha_rounds,
+                                       unsigned lanes);
+
+/*
+ * Streaming variant of slowcrypt_balloon_kchacha_parallel().
+ * `pw` has to be set up like for slowcrypt_balloon_kchacha_final().
+ *
+ * Also zeroizes `pw`, even on failure.
+ *
+ * Returns:
+ * - 0 on success
+ * - 1 out of memory, or `lanes` is too large to allocate
+ */
+int slowcrypt_balloon_kchacha_parallel_final(uint8_t out[32],
+                                             slowcrypt_kchacha_ctx* pw,
+                                             uint8_t const salt[],
+                                             unsigned salt_len,
+                                             unsigned buffer_size,
+                                             unsigned balloon_rounds,
+                                             unsigned lanes);
+
 /*
  * Arguments:
  * - `key`:
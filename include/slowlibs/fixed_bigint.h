@@ -22,8 +22,19 @@
  *     If defined, does not use clearly non-constant time algorithms.
  *     NOTE that this does not guarantee that the implementation is actually constant time, as it depends on the compiler and platform.
  *     Use a non-optimizing compiler to make sure that the implementation is actually constant time. 
+ * - SLOWCRYPT_ALLOW_TIMING_ATTACKS:
+ *     If defined, and SLOWLIBS_FBIG_CONSTANT_TIME is not, the Montgomery and Barrett
+ *     reductions use faster non-constant time final subtractions.
+ * - SLOWLIBS_FBIG_PART_BITS:
+ *     32 or 64. Size of the parts (limbs) of the big integers, defaults to 32.
+ *     64 requires `unsigned __int128` (GCC / clang on 64-bit targets),
+ *     and needs a quarter as many partial products in multiplications.
+ * - SLOWLIBS_FBIG_KARATSUBA_BITS:
+ *     Multiplications of equally wide operands at least this wide use Karatsuba.
+ *     Defaults to 32 parts (1024 bits with 32-bit parts).
  * - slowlib_fbig_part:
  *     The type of the individual parts of the big integer. Must be an unsigned integer type.
+ *     If you define this, also define SLOWLIBS_FBIG_PART_BITS to match.
  *     The default can NOT be relied on!
  * - slowlib_fbig_double_part:
  *     A unsigned integer at least twice as wide as slowlib_fbig_part, used for intermediate values in multiplication and addition.
@@ -60,16 +71,33 @@
 // TODO: there are definitely still some non-constant time algorithms in here, need to review and fix those
 // TODO: put some impls into functions
 
+#ifndef SLOWLIBS_FBIG_PART_BITS
+#define SLOWLIBS_FBIG_PART_BITS 32
+#endif
+
 #ifndef slowlib_fbig_part
 // biggest is on the right
+#if SLOWLIBS_FBIG_PART_BITS == 64
+#ifndef __SIZEOF_INT128__
+#error "SLOWLIBS_FBIG_PART_BITS == 64 requires unsigned __int128"
+#endif
+typedef uint64_t slowlib_fbig_part;
+__extension__ typedef unsigned __int128 slowlib_fbig_double_part;
+#else
 typedef uint32_t slowlib_fbig_part;
 typedef uint64_t slowlib_fbig_double_part;
 #endif
+#endif
 
+#if SLOWLIBS_FBIG_PART_BITS == 64
+#define slowlib_fbig_const_part_u64(u64) ((uint64_t)(u64))
+#else
 #define slowlib_fbig_const_part_u64(u64) \
   ((uint64_t)(u64) & 0xFFFFFFFF), (((uint64_t)(u64) >> 32) & 0xFFFFFFFF)
+#endif
 
-#define slowlib_fbig(bitwidth) (((bitwidth) + 31) / 32)
+#define slowlib_fbig(bitwidth) \
+  (((bitwidth) + SLOWLIBS_FBIG_PART_BITS - 1) / SLOWLIBS_FBIG_PART_BITS)
 
 /**
  * Example:
@@ -107,6 +135,8 @@ typedef uint64_t slowlib_fbig_double_part;
 typedef char slowlib_fbig__static_assertion__part_sizes
     [(sizeof(slowlib_fbig_double_part) >= 2 * sizeof(slowlib_fbig_part)) ? 1
                                                                          : -1];
+typedef char slowlib_fbig__static_assertion__part_bits
+    [(sizeof(slowlib_fbig_part) * 8 == SLOWLIBS_FBIG_PART_BITS) ? 1 : -1];
 
 #define slowlib_fbig_zext(out, src)                                            \
   do {                                                                         \
@@ -157,6 +187,193 @@ typedef char slowlib_fbig__static_assertion__part_sizes
     }                                                                       \
   } while (0)
 
+/* ======== Multiplication kernels ======== */
+
+/* out = a - b over n parts, returns the borrow (0 or 1) */
+static inline slowlib_fbig_part slowlib_fbig__sub_n(slowlib_fbig_part* out,
+                                                   slowlib_fbig_part const* a,
+                                                   slowlib_fbig_part const* b,
+                                                   size_t n)
+{
+  slowlib_fbig_part borrow = 0;
+  slowlib_fbig_double_part diff;
+  size_t i;
+  for (i = 0; i < n; i++) {
+    diff = (slowlib_fbig_double_part)a[i] - b[i] - borrow;
+    out[i] = (slowlib_fbig_part)diff;
+    borrow = (slowlib_fbig_part)(diff >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+  }
+  return borrow;
+}
+
+/* out[0 .. na + nb] = a * b
+ *
+ * Comba: computes the result column by column, with a three part accumulator,
+ * so every part of out is only written once.
+ * out must not overlap with a or b. */
+static inline void slowlib_fbig__mul_n(slowlib_fbig_part* out,
+                                       slowlib_fbig_part const* a,
+                                       size_t na,
+                                       slowlib_fbig_part const* b,
+                                       size_t nb)
+{
+  slowlib_fbig_double_part acc = 0, prod;
+  slowlib_fbig_part acc_hi = 0;
+  size_t col, i, lo, hi;
+
+  for (col = 0; col + 1 < na + nb; col++) {
+    lo = (col >= nb) ? col - nb + 1 : 0;
+    hi = (col < na) ? col : na - 1;
+    for (i = lo; i <= hi; i++) {
+      prod = (slowlib_fbig_double_part)a[i] * b[col - i];
+      acc += prod;
+      acc_hi += (slowlib_fbig_part)(acc < prod);
+    }
+    out[col] = (slowlib_fbig_part)acc;
+    acc = (acc >> slowlib_fbig_part_bits) |
+          ((slowlib_fbig_double_part)acc_hi << slowlib_fbig_part_bits);
+    acc_hi = 0;
+  }
+  out[na + nb - 1] = (slowlib_fbig_part)acc;
+}
+
+/* out[0 .. 2n] = a * a
+ *
+ * Every product a[i] * a[j] with i != j is only computed once, and then doubled.
+ * out must not overlap with a. */
+static inline void slowlib_fbig__sqr_n(slowlib_fbig_part* out,
+                                       slowlib_fbig_part const* a,
+                                       size_t n)
+{
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry, next;
+  size_t i, j;
+
+  for (i = 0; i < 2 * n; i++)
+    out[i] = 0;
+
+  /* sum of a[i] * a[j] for i < j */
+  for (i = 0; i + 1 < n; i++) {
+    carry = 0;
+    for (j = i + 1; j < n; j++) {
+      acc = (slowlib_fbig_double_part)a[i] * a[j] + out[i + j] + carry;
+      out[i + j] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+    out[i + n] = carry;
+  }
+
+  /* times two */
+  carry = 0;
+  for (i = 0; i < 2 * n; i++) {
+    next = out[i] >> (slowlib_fbig_part_bits - 1);
+    out[i] = (slowlib_fbig_part)((out[i] << 1) | carry);
+    carry = next;
+  }
+
+  /* plus the squares on the diagonal */
+  carry = 0;
+  for (i = 0; i < n; i++) {
+    acc = (slowlib_fbig_double_part)a[i] * a[i] + out[2 * i] + carry;
+    out[2 * i] = (slowlib_fbig_part)acc;
+    acc = (slowlib_fbig_double_part)out[2 * i + 1] +
+          (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    out[2 * i + 1] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+  }
+}
+
+#ifndef SLOWLIBS_FBIG_KARATSUBA_BITS
+/* measured crossover: below 32 parts Comba is faster */
+#define SLOWLIBS_FBIG_KARATSUBA_BITS (32 * SLOWLIBS_FBIG_PART_BITS)
+#endif
+
+#define slowlib_fbig__karatsuba_parts \
+  (SLOWLIBS_FBIG_KARATSUBA_BITS / SLOWLIBS_FBIG_PART_BITS)
+
+#if SLOWLIBS_FBIG_KARATSUBA_BITS / SLOWLIBS_FBIG_PART_BITS < 4
+#error "SLOWLIBS_FBIG_KARATSUBA_BITS has to be at least 4 parts"
+#endif
+
+/* upper bound for the scratch space of slowlib_fbig__karatsuba */
+#define slowlib_fbig__karatsuba_scratch(n) (4 * (n) + 256)
+
+/* out[0 .. 2n] = a * b
+ *
+ * Additive Karatsuba: no sign of (a0 - a1) to branch on,
+ * the recursion only depends on n.
+ * Squares if a == b.
+ * out must not overlap with a or b. */
+static inline void slowlib_fbig__karatsuba(slowlib_fbig_part* out,
+                                           slowlib_fbig_part const* a,
+                                           slowlib_fbig_part const* b,
+                                           size_t n,
+                                           slowlib_fbig_part* t)
+{
+  size_t const h = n / 2, hh = n - h;
+  slowlib_fbig_part* sa = t;               /* hh + 1 */
+  slowlib_fbig_part* sb = &t[hh + 1];      /* hh + 1 */
+  slowlib_fbig_part* z1 = &t[2 * hh + 2];  /* 2hh + 2 */
+  slowlib_fbig_part* rest = &t[4 * hh + 4];
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry;
+  int const sq = a == b;
+  size_t i;
+
+  if (n < slowlib_fbig__karatsuba_parts) {
+    if (sq)
+      slowlib_fbig__sqr_n(out, a, n);
+    else
+      slowlib_fbig__mul_n(out, a, n, b, n);
+    return;
+  }
+
+  /* sa = a0 + a1, sb = b0 + b1 */
+  carry = 0;
+  for (i = 0; i < hh; i++) {
+    acc = (slowlib_fbig_double_part)a[h + i] + ((i < h) ? a[i] : 0) + carry;
+    sa[i] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+  }
+  sa[hh] = carry;
+  carry = 0;
+  for (i = 0; i < hh; i++) {
+    acc = (slowlib_fbig_double_part)b[h + i] + ((i < h) ? b[i] : 0) + carry;
+    sb[i] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+  }
+  sb[hh] = carry;
+
+  slowlib_fbig__karatsuba(z1, sa, sq ? sa : sb, hh + 1, rest);
+  slowlib_fbig__karatsuba(out, a, sq ? a : b, h, rest);
+  slowlib_fbig__karatsuba(&out[2 * h], &a[h], sq ? &a[h] : &b[h], hh, rest);
+
+  /* z1 = (a0 + a1)(b0 + b1) - a0 b0 - a1 b1 */
+  carry = slowlib_fbig__sub_n(z1, z1, out, 2 * h);
+  for (i = 2 * h; i < 2 * hh + 2; i++) {
+    acc = (slowlib_fbig_double_part)z1[i] - carry;
+    z1[i] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+  }
+  carry = slowlib_fbig__sub_n(z1, z1, &out[2 * h], 2 * hh);
+  for (i = 2 * hh; i < 2 * hh + 2; i++) {
+    acc = (slowlib_fbig_double_part)z1[i] - carry;
+    z1[i] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+  }
+
+  /* out += z1 * W^h; z1 < 2 W^(2hh), so the parts that do not fit are zero */
+  carry = 0;
+  for (i = h; i < 2 * n; i++) {
+    acc = (slowlib_fbig_double_part)out[i] +
+          ((i - h < 2 * hh + 2) ? z1[i - h] : 0) + carry;
+    out[i] = (slowlib_fbig_part)acc;
+    carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+  }
+}
+
+/* Uses Karatsuba for equally wide operands of at least SLOWLIBS_FBIG_KARATSUBA_BITS,
+ * and Comba otherwise. Decided at compile time. */
 #define slowlib_fbig_mul(out, a, b)                                           \
   do {                                                                        \
     slowlib_fbig_part* _outp = (out);                                         \
@@ -164,22 +381,39 @@ typedef char slowlib_fbig__static_assertion__part_sizes
     slowlib_fbig_part const* _bp = (b);                                       \
     slowlib_fbig_static_assert(sizeof((out)) >= sizeof((a)) + sizeof((b)),    \
                                out_too_small);                                \
-    /* FIX: Declare array directly using the part count */                    \
-    slowlib_fbig_part _temp[sizeof((out)) / sizeof(slowlib_fbig_part)] = {0}; \
-    for (size_t _i = 0; _i < slowlib_fbig_np((a)); _i++) {                    \
-      slowlib_fbig_part _carry = 0;                                           \
-      for (size_t _j = 0; _j < slowlib_fbig_np((b)); _j++) {                  \
-        slowlib_fbig_double_part _prod =                                      \
-            (slowlib_fbig_double_part)(_ap[_i]) *                             \
-                (slowlib_fbig_double_part)_bp[_j] +                           \
-            _temp[_i + _j] + _carry;                                          \
-        _temp[_i + _j] = (slowlib_fbig_part)_prod;                            \
-        _carry = (slowlib_fbig_part)(_prod >> slowlib_fbig_part_bits);        \
-      }                                                                       \
-      _temp[_i + slowlib_fbig_np((b))] += _carry;                             \
+    slowlib_fbig_part _temp[sizeof((out)) / sizeof(slowlib_fbig_part)];       \
+    if (slowlib_fbig_np((a)) == slowlib_fbig_np((b)) &&                       \
+        slowlib_fbig_np((a)) >= slowlib_fbig__karatsuba_parts) {              \
+      slowlib_fbig_part _kt[slowlib_fbig__karatsuba_scratch(                  \
+          sizeof((a)) / sizeof(slowlib_fbig_part))];                          \
+      slowlib_fbig__karatsuba(_temp, _ap, _bp, slowlib_fbig_np((a)), _kt);    \
+    } else {                                                                  \
+      slowlib_fbig__mul_n(_temp, _ap, slowlib_fbig_np((a)), _bp,              \
+                          slowlib_fbig_np((b)));                              \
     }                                                                         \
     for (size_t _i = 0; _i < slowlib_fbig_np((out)); _i++) {                  \
-      _outp[_i] = _temp[_i];                                                  \
+      _outp[_i] =                                                             \
+          (_i < slowlib_fbig_np((a)) + slowlib_fbig_np((b))) ? _temp[_i] : 0; \
+    }                                                                         \
+  } while (0)
+
+/* out = a * a */
+#define slowlib_fbig_sqr(out, a)                                              \
+  do {                                                                        \
+    slowlib_fbig_part* _outp = (out);                                         \
+    slowlib_fbig_part const* _ap = (a);                                       \
+    slowlib_fbig_static_assert(sizeof((out)) >= 2 * sizeof((a)),              \
+                               out_too_small);                                \
+    slowlib_fbig_part _temp[sizeof((out)) / sizeof(slowlib_fbig_part)];       \
+    if (slowlib_fbig_np((a)) >= slowlib_fbig__karatsuba_parts) {              \
+      slowlib_fbig_part _kt[slowlib_fbig__karatsuba_scratch(                  \
+          sizeof((a)) / sizeof(slowlib_fbig_part))];                          \
+      slowlib_fbig__karatsuba(_temp, _ap, _ap, slowlib_fbig_np((a)), _kt);    \
+    } else {                                                                  \
+      slowlib_fbig__sqr_n(_temp, _ap, slowlib_fbig_np((a)));                  \
+    }                                                                         \
+    for (size_t _i = 0; _i < slowlib_fbig_np((out)); _i++) {                  \
+      _outp[_i] = (_i < 2 * slowlib_fbig_np((a))) ? _temp[_i] : 0;            \
     }                                                                         \
   } while (0)
 
@@ -241,7 +475,9 @@ typedef char slowlib_fbig__static_assertion__part_sizes
           slowlib_fbig_double_part _diff =                                    \
               (slowlib_fbig_double_part)_rem[_j] - _m_val - _borrow;          \
           _rem[_j] = (slowlib_fbig_part)_diff;                                \
-          _borrow = (_diff >> 63) & 1;                                        \
+          _borrow = (slowlib_fbig_part)(_diff >>                              \
+                                        (2 * slowlib_fbig_part_bits - 1)) &   \
+                    1;                                                        \
         }                                                                     \
       }                                                                       \
     }                                                                         \
@@ -308,4 +544,921 @@ typedef char slowlib_fbig__static_assertion__part_sizes
     }                                                                        \
   } while (0)
 
+/* ======== Modular reduction with precomputed contexts ========
+ *
+ * Much faster than slowlib_fbig_umod when reducing by the same modulus many times.
+ *
+ * Example:
+ * ```c
+ * slowlib_fbig_mont_ctx(256, ctx);
+ * slowlib_fbig_mont_init(ctx, modulus); // modulus has to be odd
+ * slowlib_fbig_to_mont(a, a, ctx);
+ * slowlib_fbig_to_mont(b, b, ctx);
+ * slowlib_fbig_mont_mul(a, a, b, ctx); // a = a * b mod m, in Montgomery form
+ * slowlib_fbig_from_mont(a, a, ctx);
+ * ```
+ */
+
+#if defined(SLOWCRYPT_ALLOW_TIMING_ATTACKS) && \
+    !defined(SLOWLIBS_FBIG_CONSTANT_TIME)
+#define SLOWLIBS_FBIG__VARIABLE_TIME
+#endif
+
+/* r = (r >= m) ? r - m : r
+ *
+ * r has n + 1 parts, m has n parts.
+ * scratch needs n parts.
+ * returns 1 if m was subtracted */
+static inline slowlib_fbig_part slowlib_fbig__csub(slowlib_fbig_part* r,
+                                                  slowlib_fbig_part const* m,
+                                                  size_t n,
+                                                  slowlib_fbig_part* scratch)
+{
+#ifdef SLOWLIBS_FBIG__VARIABLE_TIME
+  size_t i;
+  (void)scratch;
+  if (r[n] == 0) {
+    for (i = n; i-- > 0;) {
+      if (r[i] != m[i]) {
+        if (r[i] < m[i])
+          return 0;
+        break;
+      }
+    }
+  }
+  r[n] -= slowlib_fbig__sub_n(r, r, m, n);
+  return 1;
+#else
+  slowlib_fbig_part borrow, hi, hi_zero, take, mask;
+  size_t i;
+
+  borrow = slowlib_fbig__sub_n(scratch, r, m, n);
+  hi = r[n];
+  hi_zero = (slowlib_fbig_part)(((hi | (slowlib_fbig_part)(0 - hi)) >>
+                                 (slowlib_fbig_part_bits - 1)) ^
+                                1);
+  /* the subtraction only underflowed if the borrow did not fit into r[n] */
+  take = (hi_zero & borrow) ^ 1;
+  mask = (slowlib_fbig_part)(0 - take);
+  for (i = 0; i < n; i++)
+    r[i] = (scratch[i] & mask) | (r[i] & (slowlib_fbig_part)~mask);
+  r[n] = (slowlib_fbig_part)(hi - (borrow & take));
+  return take;
+#endif
+}
+
+/* t needs 2 * n + 2 parts */
+static inline void slowlib_fbig__mont_mul(slowlib_fbig_part* out,
+                                          slowlib_fbig_part const* a,
+                                          slowlib_fbig_part const* b,
+                                          slowlib_fbig_part const* m,
+                                          slowlib_fbig_part minv,
+                                          size_t n,
+                                          slowlib_fbig_part* t)
+{
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry, q;
+  size_t i, j;
+
+  for (i = 0; i < n + 2; i++)
+    t[i] = 0;
+
+  /* CIOS: t = (t + a * b[i] + q * m) / 2^bits, for every part of b */
+  for (i = 0; i < n; i++) {
+    carry = 0;
+    for (j = 0; j < n; j++) {
+      acc = (slowlib_fbig_double_part)a[j] * b[i] + t[j] + carry;
+      t[j] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+    acc = (slowlib_fbig_double_part)t[n] + carry;
+    t[n] = (slowlib_fbig_part)acc;
+    t[n + 1] = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+
+    q = (slowlib_fbig_part)((slowlib_fbig_double_part)t[0] * minv);
+    acc = (slowlib_fbig_double_part)q * m[0] + t[0];
+    carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    for (j = 1; j < n; j++) {
+      acc = (slowlib_fbig_double_part)q * m[j] + t[j] + carry;
+      t[j - 1] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+    acc = (slowlib_fbig_double_part)t[n] + carry;
+    t[n - 1] = (slowlib_fbig_part)acc;
+    t[n] = (slowlib_fbig_part)(t[n + 1] + (acc >> slowlib_fbig_part_bits));
+  }
+
+  /* t < 2m */
+  slowlib_fbig__csub(t, m, n, &t[n + 2]);
+  for (i = 0; i < n; i++)
+    out[i] = t[i];
+}
+
+/* t needs 2 * n + 2 parts */
+static inline void slowlib_fbig__mont_setup(slowlib_fbig_part* r2,
+                                            slowlib_fbig_part* minv,
+                                            slowlib_fbig_part const* m,
+                                            size_t n,
+                                            slowlib_fbig_part* t)
+{
+  slowlib_fbig_part inv = m[0], carry, next;
+  size_t i, j;
+
+  /* Newton iteration: every step doubles the number of correct low bits */
+  for (i = 3; i < slowlib_fbig_part_bits; i *= 2)
+    inv = (slowlib_fbig_part)(inv * (slowlib_fbig_part)(2 - m[0] * inv));
+  *minv = (slowlib_fbig_part)(0 - inv);
+
+  /* R^2 mod m, by doubling 1 (2 * n * bits) times */
+  for (i = 0; i < n + 1; i++)
+    t[i] = 0;
+  t[0] = 1;
+  for (i = 0; i < 2 * n * slowlib_fbig_part_bits; i++) {
+    carry = 0;
+    for (j = 0; j < n + 1; j++) {
+      next = t[j] >> (slowlib_fbig_part_bits - 1);
+      t[j] = (slowlib_fbig_part)((t[j] << 1) | carry);
+      carry = next;
+    }
+    slowlib_fbig__csub(t, m, n, &t[n + 1]);
+  }
+  for (i = 0; i < n; i++)
+    r2[i] = t[i];
+}
+
+/* t needs 5 * k + 6 parts */
+static inline void slowlib_fbig__barrett(slowlib_fbig_part* out,
+                                         size_t nout,
+                                         slowlib_fbig_part const* x,
+                                         size_t nx,
+                                         slowlib_fbig_part const* m,
+                                         slowlib_fbig_part const* mu,
+                                         size_t k,
+                                         slowlib_fbig_part* t)
+{
+  slowlib_fbig_part* q1 = t;               /* k + 1 */
+  slowlib_fbig_part* q2 = &t[k + 1];       /* 2k + 3 */
+  slowlib_fbig_part* q3 = &q2[k + 1];      /* k + 1, aliases q2 */
+  slowlib_fbig_part* r = &t[3 * k + 4];    /* k + 1 */
+  slowlib_fbig_part* qm = &t[4 * k + 5];   /* k + 1 */
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry;
+  size_t i, j;
+
+  /* q3 = ((x / W^(k-1)) * mu) / W^(k+1) */
+  for (i = 0; i < k + 1; i++)
+    q1[i] = (k - 1 + i < nx) ? x[k - 1 + i] : 0;
+  slowlib_fbig__mul_n(q2, q1, k + 1, mu, k + 2);
+
+  /* qm = (q3 * m) mod W^(k+1) */
+  for (i = 0; i < k + 1; i++)
+    qm[i] = 0;
+  for (i = 0; i < k + 1; i++) {
+    carry = 0;
+    for (j = 0; j < k && i + j < k + 1; j++) {
+      acc = (slowlib_fbig_double_part)q3[i] * m[j] + qm[i + j] + carry;
+      qm[i + j] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+    if (i + k < k + 1)
+      qm[i + k] = carry;
+  }
+
+  /* r = (x - q3 * m) mod W^(k+1), which is < 3m */
+  for (i = 0; i < k + 1; i++)
+    r[i] = (i < nx) ? x[i] : 0;
+  slowlib_fbig__sub_n(r, r, qm, k + 1);
+  slowlib_fbig__csub(r, m, k, q1);
+  slowlib_fbig__csub(r, m, k, q1);
+
+  for (i = 0; i < nout; i++)
+    out[i] = (i < k) ? r[i] : 0;
+}
+
+/* returns k; t needs 2 * n + 2 parts */
+static inline size_t slowlib_fbig__barrett_setup(slowlib_fbig_part* mu,
+                                                 slowlib_fbig_part const* m,
+                                                 size_t n,
+                                                 slowlib_fbig_part* t)
+{
+  slowlib_fbig_part* r = t; /* k + 1 */
+  slowlib_fbig_part carry, next, take;
+  size_t k = n, i, j, bit;
+
+  while (k > 1 && m[k - 1] == 0)
+    k--;
+
+  /* mu = W^(2k) / m, by restoring division */
+  for (i = 0; i < k + 2; i++)
+    mu[i] = 0;
+  for (i = 0; i < k + 1; i++)
+    r[i] = 0;
+  for (bit = 2 * k * slowlib_fbig_part_bits + 1; bit-- > 0;) {
+    carry = bit == 2 * k * slowlib_fbig_part_bits;
+    for (j = 0; j < k + 1; j++) {
+      next = r[j] >> (slowlib_fbig_part_bits - 1);
+      r[j] = (slowlib_fbig_part)((r[j] << 1) | carry);
+      carry = next;
+    }
+    take = slowlib_fbig__csub(r, m, k, &t[k + 1]);
+    /* the quotient has at most k + 2 parts */
+    if (bit / slowlib_fbig_part_bits < k + 2)
+      mu[bit / slowlib_fbig_part_bits] |=
+          (slowlib_fbig_part)(take << (bit % slowlib_fbig_part_bits));
+  }
+  return k;
+}
+
+/* like zext, but allows mod to be wider (slowlib_fbig_const pads),
+ * as long as the value fits */
+#define slowlib_fbig__copy_mod(out, mod)                                   \
+  do {                                                                     \
+    slowlib_fbig_part const* _modp = (mod);                                \
+    for (size_t _i = 0; _i < slowlib_fbig_np((out)); _i++)                 \
+      (out)[_i] = (_i < slowlib_fbig_np((mod))) ? _modp[_i] : 0;           \
+  } while (0)
+
+/* Montgomery context for a odd modulus that fits into `width` */
+#define slowlib_fbig_mont_ctx(width, name) \
+  struct                                   \
+  {                                        \
+    slowlib_fbig_var((width), m);          \
+    slowlib_fbig_var((width), r2);         \
+    slowlib_fbig_part minv;                \
+  } name
+
+#define slowlib_fbig_mont_init(ctx, mod)                                     \
+  do {                                                                       \
+    slowlib_fbig_part                                                        \
+        _t[2 * (sizeof((ctx).m) / sizeof(slowlib_fbig_part)) + 2];           \
+    slowlib_fbig__copy_mod((ctx).m, (mod));                                  \
+    slowlib_fbig__mont_setup((ctx).r2, &(ctx).minv, (ctx).m,                 \
+                             slowlib_fbig_np((ctx).m), _t);                  \
+  } while (0)
+
+/* out = a * b / R mod m
+ *
+ * a and b have to be smaller than m.
+ * all have to be the width of the context. */
+#define slowlib_fbig_mont_mul(out, a, b, ctx)                               \
+  do {                                                                      \
+    slowlib_fbig_part                                                       \
+        _t[2 * (sizeof((ctx).m) / sizeof(slowlib_fbig_part)) + 2];          \
+    slowlib_fbig_static_assert(sizeof((out)) == sizeof((ctx).m) &&          \
+                                   sizeof((a)) == sizeof((ctx).m) &&        \
+                                   sizeof((b)) == sizeof((ctx).m),          \
+                               width_mismatch);                             \
+    slowlib_fbig__mont_mul((out), (a), (b), (ctx).m, (ctx).minv,            \
+                           slowlib_fbig_np((ctx).m), _t);                   \
+  } while (0)
+
+/* out = a * R mod m */
+#define slowlib_fbig_to_mont(out, a, ctx) \
+  slowlib_fbig_mont_mul(out, a, (ctx).r2, ctx)
+
+/* out = a / R mod m */
+#define slowlib_fbig_from_mont(out, a, ctx)                           \
+  do {                                                                \
+    slowlib_fbig_part _one[sizeof((ctx).m) / sizeof(slowlib_fbig_part)]; \
+    slowlib_fbig_zext_scalar(_one, 1);                                \
+    slowlib_fbig_mont_mul(out, a, _one, ctx);                         \
+  } while (0)
+
+/* Barrett context for a non-zero modulus that fits into `width` */
+#define slowlib_fbig_barrett_ctx(width, name)   \
+  struct                                        \
+  {                                             \
+    slowlib_fbig_var((width), m);               \
+    slowlib_fbig_part mu[slowlib_fbig((width)) + 2]; \
+    size_t k;                                   \
+  } name
+
+#define slowlib_fbig_barrett_init(ctx, mod)                                  \
+  do {                                                                       \
+    slowlib_fbig_part                                                        \
+        _t[2 * (sizeof((ctx).m) / sizeof(slowlib_fbig_part)) + 2];           \
+    slowlib_fbig__copy_mod((ctx).m, (mod));                                  \
+    (ctx).k = slowlib_fbig__barrett_setup((ctx).mu, (ctx).m,                 \
+                                          slowlib_fbig_np((ctx).m), _t);     \
+  } while (0)
+
+/* out = a mod m
+ *
+ * a has to be smaller than m * m, and can be at most twice the width of the context. */
+#define slowlib_fbig_barrett(out, a, ctx)                                      \
+  do {                                                                         \
+    slowlib_fbig_part                                                          \
+        _t[5 * (sizeof((ctx).m) / sizeof(slowlib_fbig_part)) + 6];             \
+    slowlib_fbig_static_assert(sizeof((out)) >= sizeof((ctx).m),               \
+                               out_too_small);                                 \
+    slowlib_fbig_static_assert(sizeof((a)) <= 2 * sizeof((ctx).m),             \
+                               a_too_large);                                   \
+    slowlib_fbig__barrett((out), slowlib_fbig_np((out)), (a),                  \
+                          slowlib_fbig_np((a)), (ctx).m, (ctx).mu, (ctx).k,    \
+                          _t);                                                 \
+  } while (0)
+
+/* t needs 4 * (na + n / bits + 2) parts */
+static inline void slowlib_fbig__reduce_pm(slowlib_fbig_part* out,
+                                           size_t nout,
+                                           slowlib_fbig_part const* a,
+                                           size_t na,
+                                           size_t n,
+                                           slowlib_fbig_part c,
+                                           slowlib_fbig_part* t)
+{
+  size_t const k = n / slowlib_fbig_part_bits + 1;
+  size_t const nx = (na > k ? na : k) + 1;
+  size_t const ws = n / slowlib_fbig_part_bits;
+  size_t const bs = n % slowlib_fbig_part_bits;
+  slowlib_fbig_part* x = t;
+  slowlib_fbig_part* hi = &t[nx];
+  slowlib_fbig_part* p = &hi[nx];
+  slowlib_fbig_part* scratch = &p[nx];
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry, borrow;
+  size_t bits = na * slowlib_fbig_part_bits, cbits = 0, nhi, i;
+
+  while (cbits < slowlib_fbig_part_bits && (c >> cbits))
+    cbits++;
+
+  for (i = 0; i < nx; i++)
+    x[i] = (i < na) ? a[i] : 0;
+
+  /* x = (x mod 2^n) + c * (x >> n), until x < 2^(n+1)
+   * the number of folds only depends on the widths */
+  while (bits > n + 1) {
+    nhi = (bits - n + slowlib_fbig_part_bits - 1) / slowlib_fbig_part_bits;
+    for (i = 0; i < nhi; i++) {
+      hi[i] = x[ws + i] >> bs;
+      if (bs != 0 && ws + i + 1 < nx)
+        hi[i] |= (slowlib_fbig_part)(x[ws + i + 1]
+                                     << (slowlib_fbig_part_bits - bs));
+    }
+    x[ws] &= (slowlib_fbig_part)(((slowlib_fbig_part)1 << bs) - 1);
+    for (i = ws + 1; i < nx; i++)
+      x[i] = 0;
+
+    carry = 0;
+    for (i = 0; i < nx; i++) {
+      acc = (slowlib_fbig_double_part)((i < nhi) ? hi[i] : 0) * c + x[i] +
+            carry;
+      x[i] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+
+    bits = ((bits - n + cbits > n) ? bits - n + cbits : n) + 1;
+  }
+
+  /* p = 2^n - c */
+  borrow = c;
+  for (i = 0; i < k; i++) {
+    acc = (slowlib_fbig_double_part)((i == ws) ? (slowlib_fbig_part)1 << bs
+                                               : 0) -
+          borrow;
+    p[i] = (slowlib_fbig_part)acc;
+    borrow = (slowlib_fbig_part)(acc >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+  }
+
+  /* x < 2^(n+1) = 2p + 2c */
+  slowlib_fbig__csub(x, p, k, scratch);
+  slowlib_fbig__csub(x, p, k, scratch);
+
+  for (i = 0; i < nout; i++)
+    out[i] = (i < k) ? x[i] : 0;
+}
+
+/* out = a mod (2^n - c)
+ *
+ * For pseudo-Mersenne moduli like 2^130 - 5 or 2^255 - 19.
+ * n and c should be constants. c has to fit into a part, and be much smaller than 2^n.
+ * Only uses a couple of multiply-by-c folds, no division. */
+#define slowlib_fbig_reduce_pm(out, a, n, c)                                 \
+  do {                                                                       \
+    slowlib_fbig_part _t[4 * (sizeof((a)) / sizeof(slowlib_fbig_part) +      \
+                              (n) / (sizeof(slowlib_fbig_part) * 8) + 2)];   \
+    slowlib_fbig_static_assert(sizeof((out)) * 8 >= (n), out_too_small);     \
+    slowlib_fbig__reduce_pm((out), slowlib_fbig_np((out)), (a),              \
+                            slowlib_fbig_np((a)), (n), (c), _t);             \
+  } while (0)
+
+/* ======== Variable-time division ======== */
+
+/* t needs na + nm + 1 parts */
+static inline void slowlib_fbig__udivmod_vt(slowlib_fbig_part* q,
+                                            size_t nq,
+                                            slowlib_fbig_part* r,
+                                            size_t nr,
+                                            slowlib_fbig_part const* a,
+                                            size_t na,
+                                            slowlib_fbig_part const* m,
+                                            size_t nm,
+                                            slowlib_fbig_part* t)
+{
+  slowlib_fbig_double_part const base = (slowlib_fbig_double_part)1
+                                        << slowlib_fbig_part_bits;
+  slowlib_fbig_part* vn = t;      /* n */
+  slowlib_fbig_part* un = &t[nm]; /* la + 1 */
+  slowlib_fbig_double_part qhat, rhat, p, diff, cur;
+  slowlib_fbig_part carry, borrow, top;
+  size_t n = nm, la = na, s = 0, i, j;
+
+  while (n > 0 && m[n - 1] == 0)
+    n--;
+  while (la > 0 && a[la - 1] == 0)
+    la--;
+
+  if (n == 0) {
+    volatile int _trap = 0;
+    _trap = 1 / _trap;
+    return;
+  }
+
+  for (i = 0; i < nq; i++)
+    q[i] = 0;
+
+  /* a < m */
+  if (la < n) {
+    for (i = 0; i < nr; i++)
+      r[i] = (i < la) ? a[i] : 0;
+    return;
+  }
+
+  /* single part divisor: just divide part by part */
+  if (n == 1) {
+    cur = 0;
+    for (i = la; i-- > 0;) {
+      cur = (cur << slowlib_fbig_part_bits) | a[i];
+      q[i] = (slowlib_fbig_part)(cur / m[0]);
+      cur %= m[0];
+    }
+    for (i = 0; i < nr; i++)
+      r[i] = (i == 0) ? (slowlib_fbig_part)cur : 0;
+    return;
+  }
+
+  /* Knuth, TAOCP Vol. 2, 4.3.1, Algorithm D */
+
+  /* D1: normalize, so that the top bit of the divisor is set */
+  for (top = m[n - 1]; !(top >> (slowlib_fbig_part_bits - 1)); top <<= 1)
+    s++;
+  for (i = n; i-- > 0;)
+    vn[i] = (slowlib_fbig_part)((m[i] << s) |
+                                ((s && i) ? m[i - 1] >> (slowlib_fbig_part_bits - s)
+                                          : 0));
+  un[la] = s ? a[la - 1] >> (slowlib_fbig_part_bits - s) : 0;
+  for (i = la; i-- > 0;)
+    un[i] = (slowlib_fbig_part)((a[i] << s) |
+                                ((s && i) ? a[i - 1] >> (slowlib_fbig_part_bits - s)
+                                          : 0));
+
+  for (j = la - n + 1; j-- > 0;) {
+    /* D3: estimate the quotient part from the top two parts */
+    cur = ((slowlib_fbig_double_part)un[j + n] << slowlib_fbig_part_bits) |
+          un[j + n - 1];
+    qhat = cur / vn[n - 1];
+    rhat = cur % vn[n - 1];
+    while (qhat >= base ||
+           qhat * vn[n - 2] > ((rhat << slowlib_fbig_part_bits) | un[j + n - 2])) {
+      qhat--;
+      rhat += vn[n - 1];
+      if (rhat >= base)
+        break;
+    }
+
+    /* D4: un[j .. j + n] -= qhat * vn */
+    carry = 0;
+    borrow = 0;
+    for (i = 0; i < n; i++) {
+      p = qhat * vn[i] + carry;
+      carry = (slowlib_fbig_part)(p >> slowlib_fbig_part_bits);
+      diff = (slowlib_fbig_double_part)un[i + j] - (slowlib_fbig_part)p - borrow;
+      un[i + j] = (slowlib_fbig_part)diff;
+      borrow = (slowlib_fbig_part)(diff >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+    }
+    diff = (slowlib_fbig_double_part)un[j + n] - carry - borrow;
+    un[j + n] = (slowlib_fbig_part)diff;
+    borrow = (slowlib_fbig_part)(diff >> (2 * slowlib_fbig_part_bits - 1)) & 1;
+
+    /* D6: qhat was one too large, add back */
+    if (borrow) {
+      qhat--;
+      carry = 0;
+      for (i = 0; i < n; i++) {
+        p = (slowlib_fbig_double_part)un[i + j] + vn[i] + carry;
+        un[i + j] = (slowlib_fbig_part)p;
+        carry = (slowlib_fbig_part)(p >> slowlib_fbig_part_bits);
+      }
+      un[j + n] += carry;
+    }
+
+    if (j < nq)
+      q[j] = (slowlib_fbig_part)qhat;
+  }
+
+  /* D8: un >> s is the remainder */
+  for (i = 0; i < nr; i++) {
+    if (i < n)
+      r[i] = (slowlib_fbig_part)((un[i] >> s) |
+                                 (s ? un[i + 1] << (slowlib_fbig_part_bits - s)
+                                    : 0));
+    else
+      r[i] = 0;
+  }
+}
+
+/* q = a / m, r = a mod m
+ *
+ * NOT constant time! Only use this on public data.
+ * Divisors that fit into a single part only need one division per part of a. */
+#define slowlib_fbig_udivmod_vt(q, r, a, m)                                  \
+  do {                                                                       \
+    slowlib_fbig_part _t[sizeof((a)) / sizeof(slowlib_fbig_part) +           \
+                         sizeof((m)) / sizeof(slowlib_fbig_part) + 1];       \
+    slowlib_fbig_static_assert(sizeof((q)) >= sizeof((a)), q_too_small);     \
+    slowlib_fbig_static_assert(sizeof((r)) >= sizeof((m)), r_too_small);     \
+    slowlib_fbig__udivmod_vt((q), slowlib_fbig_np((q)), (r),                 \
+                             slowlib_fbig_np((r)), (a), slowlib_fbig_np((a)), \
+                             (m), slowlib_fbig_np((m)), _t);                 \
+  } while (0)
+
+/* ======== Batches ========
+ *
+ * Struct-of-arrays storage for many independent numbers of the same width:
+ * every batch holds SLOWLIBS_FBIG_BATCH_LANES numbers, and part i of lane l
+ * is at batch[i][l], so every operation works on all lanes at once,
+ * one number per SIMD element.
+ *
+ * Uses GCC / clang vector extensions when parts are 32 bits wide.
+ * Compile with -mavx2 to do all 4 lanes of a batch with one AVX2 instruction:
+ * about twice the throughput of the single-number operations.
+ * Without AVX2 it is about as fast as them.
+ * With 64-bit parts, it falls back to one lane at a time.
+ * All batch operations are constant time, like their single-number versions.
+ *
+ * Example:
+ * ```c
+ * slowlib_fbig_batch_var(256, a, 4);   // 4 batches = 16 numbers
+ * slowlib_fbig_batch_var(256, b, 4);
+ * slowlib_fbig_batch_var(512, prod, 4);
+ * slowlib_fbig_batch_set(a, 17, x);    // a[17] = x
+ * ...
+ * slowlib_fbig_batch_mul(prod, a, b, 4);
+ * slowlib_fbig_batch_get(y, prod, 17); // y = x * b[17]
+ * ```
+ */
+
+#define SLOWLIBS_FBIG_BATCH_LANES 4
+
+#define slowlib_fbig_batch_var(width, name, nbatches) \
+  slowlib_fbig_part name[(nbatches)][slowlib_fbig((width))] \
+                        [SLOWLIBS_FBIG_BATCH_LANES]
+
+/* number of parts of one number in the batch array */
+#define slowlib_fbig_batch_np(batch) \
+  (sizeof((batch)[0]) / sizeof(slowlib_fbig_part) / SLOWLIBS_FBIG_BATCH_LANES)
+
+/* batch[idx] = x, zero-extended */
+#define slowlib_fbig_batch_set(batch, idx, x)                                \
+  do {                                                                       \
+    slowlib_fbig_part const* _xp = (x);                                      \
+    size_t _idx = (idx);                                                     \
+    slowlib_fbig_static_assert(sizeof((batch)[0]) >=                         \
+                                   sizeof((x)) * SLOWLIBS_FBIG_BATCH_LANES,  \
+                               batch_too_small);                             \
+    for (size_t _i = 0; _i < slowlib_fbig_batch_np((batch)); _i++)           \
+      (batch)[_idx / SLOWLIBS_FBIG_BATCH_LANES][_i]                          \
+             [_idx % SLOWLIBS_FBIG_BATCH_LANES] =                            \
+          (_i < slowlib_fbig_np((x))) ? _xp[_i] : 0;                         \
+  } while (0)
+
+/* x = batch[idx], zero-extended or truncated */
+#define slowlib_fbig_batch_get(x, batch, idx)                                \
+  do {                                                                       \
+    slowlib_fbig_part* _xp = (x);                                            \
+    size_t _idx = (idx);                                                     \
+    for (size_t _i = 0; _i < slowlib_fbig_np((x)); _i++)                     \
+      _xp[_i] = (_i < slowlib_fbig_batch_np((batch)))                        \
+                    ? (batch)[_idx / SLOWLIBS_FBIG_BATCH_LANES][_i]          \
+                             [_idx % SLOWLIBS_FBIG_BATCH_LANES]              \
+                    : 0;                                                     \
+  } while (0)
+
+#if (defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 9)) && \
+    SLOWLIBS_FBIG_PART_BITS == 32
+#define SLOWLIBS_FBIG__BATCH_SIMD
+#endif
+
+#ifdef SLOWLIBS_FBIG__BATCH_SIMD
+
+/* one double part per lane */
+typedef slowlib_fbig_double_part slowlib_fbig__vdp
+    __attribute__((vector_size(sizeof(slowlib_fbig_double_part) *
+                               SLOWLIBS_FBIG_BATCH_LANES)));
+
+/* one part per lane */
+typedef slowlib_fbig_part slowlib_fbig__vp
+    __attribute__((vector_size(sizeof(slowlib_fbig_part) *
+                               SLOWLIBS_FBIG_BATCH_LANES)));
+
+/* macros, not functions: vectors as arguments or return values change the ABI */
+#define slowlib_fbig__batch_load(v, row)                  \
+  do {                                                    \
+    slowlib_fbig__vp _v;                                  \
+    __builtin_memcpy(&_v, (row), sizeof(_v));             \
+    (v) = __builtin_convertvector(_v, slowlib_fbig__vdp); \
+  } while (0)
+
+#define slowlib_fbig__batch_store(row, v)                                 \
+  do {                                                                    \
+    slowlib_fbig__vp _v = __builtin_convertvector((v), slowlib_fbig__vp); \
+    __builtin_memcpy((row), &_v, sizeof(_v));                             \
+  } while (0)
+
+/* 32 x 32 -> 64-bit products of every lane.
+ * Compilers do not notice that the upper halves are zero, and emit three vpmuludq */
+#if defined(__AVX2__) && SLOWLIBS_FBIG_BATCH_LANES == 4
+typedef int slowlib_fbig__v8si __attribute__((vector_size(32)));
+#define slowlib_fbig__batch_mul32(a, b)                                 \
+  ((slowlib_fbig__vdp)__builtin_ia32_pmuludq256((slowlib_fbig__v8si)(a), \
+                                                (slowlib_fbig__v8si)(b)))
+#else
+#define slowlib_fbig__batch_mul32(a, b) \
+  (((a) & (slowlib_fbig_part)~0u) * ((b) & (slowlib_fbig_part)~0u))
+#endif
+
+#define slowlib_fbig__row(p, i) (&(p)[(i) * SLOWLIBS_FBIG_BATCH_LANES])
+
+/* out = a + b, for one batch; out has no, a na, b nb parts */
+static inline void slowlib_fbig__batch_add(slowlib_fbig_part* out,
+                                           size_t no,
+                                           slowlib_fbig_part const* a,
+                                           size_t na,
+                                           slowlib_fbig_part const* b,
+                                           size_t nb)
+{
+  slowlib_fbig__vdp const zero = {0};
+  slowlib_fbig__vdp acc, carry = zero, x;
+  size_t i;
+  for (i = 0; i < no; i++) {
+    acc = carry;
+    if (i < na) {
+      slowlib_fbig__batch_load(x, slowlib_fbig__row(a, i));
+      acc += x;
+    }
+    if (i < nb) {
+      slowlib_fbig__batch_load(x, slowlib_fbig__row(b, i));
+      acc += x;
+    }
+    slowlib_fbig__batch_store(slowlib_fbig__row(out, i), acc);
+    carry = acc >> slowlib_fbig_part_bits;
+  }
+}
+
+/* out = a * b, for one batch; out has na + nb parts */
+static inline void slowlib_fbig__batch_mul(slowlib_fbig_part* out,
+                                           slowlib_fbig_part const* a,
+                                           size_t na,
+                                           slowlib_fbig_part const* b,
+                                           size_t nb)
+{
+  slowlib_fbig__vdp const zero = {0};
+  slowlib_fbig__vdp ai, bj, o, acc, carry;
+  size_t i, j;
+
+  for (i = 0; i < na + nb; i++)
+    slowlib_fbig__batch_store(slowlib_fbig__row(out, i), zero);
+
+  /* one operand per lane */
+  for (i = 0; i < na; i++) {
+    slowlib_fbig__batch_load(ai, slowlib_fbig__row(a, i));
+    carry = zero;
+    for (j = 0; j < nb; j++) {
+      slowlib_fbig__batch_load(bj, slowlib_fbig__row(b, j));
+      slowlib_fbig__batch_load(o, slowlib_fbig__row(out, i + j));
+      acc = slowlib_fbig__batch_mul32(ai, bj) + o + carry;
+      slowlib_fbig__batch_store(slowlib_fbig__row(out, i + j), acc);
+      carry = acc >> slowlib_fbig_part_bits;
+    }
+    slowlib_fbig__batch_store(slowlib_fbig__row(out, i + nb), carry);
+  }
+}
+
+/* Montgomery multiplication of one batch with a shared modulus,
+ * see slowlib_fbig__mont_mul. t needs (n + 1) * lanes parts */
+static inline void slowlib_fbig__batch_mont_mul(slowlib_fbig_part* out,
+                                                slowlib_fbig_part const* a,
+                                                slowlib_fbig_part const* b,
+                                                slowlib_fbig_part const* m,
+                                                slowlib_fbig_part minv,
+                                                size_t n,
+                                                slowlib_fbig_part* t)
+{
+  slowlib_fbig__vdp const zero = {0};
+  slowlib_fbig__vdp const low = zero + (slowlib_fbig_part)~(slowlib_fbig_part)0;
+  slowlib_fbig__vdp x, y, bi, acc, carry, q, top, borrow, keep;
+  size_t i, j;
+
+  for (i = 0; i < n + 1; i++)
+    slowlib_fbig__batch_store(slowlib_fbig__row(t, i), zero);
+
+  for (i = 0; i < n; i++) {
+    slowlib_fbig__batch_load(bi, slowlib_fbig__row(b, i));
+    carry = zero;
+    for (j = 0; j < n; j++) {
+      slowlib_fbig__batch_load(x, slowlib_fbig__row(a, j));
+      slowlib_fbig__batch_load(y, slowlib_fbig__row(t, j));
+      acc = slowlib_fbig__batch_mul32(x, bi) + y + carry;
+      slowlib_fbig__batch_store(slowlib_fbig__row(t, j), acc);
+      carry = acc >> slowlib_fbig_part_bits;
+    }
+    slowlib_fbig__batch_load(y, slowlib_fbig__row(t, n));
+    acc = y + carry;
+    slowlib_fbig__batch_store(slowlib_fbig__row(t, n), acc);
+    top = acc >> slowlib_fbig_part_bits;
+
+    slowlib_fbig__batch_load(y, slowlib_fbig__row(t, 0));
+    q = slowlib_fbig__batch_mul32(y, zero + minv) & low;
+    acc = slowlib_fbig__batch_mul32(q, zero + m[0]) + y;
+    carry = acc >> slowlib_fbig_part_bits;
+    for (j = 1; j < n; j++) {
+      slowlib_fbig__batch_load(y, slowlib_fbig__row(t, j));
+      acc = slowlib_fbig__batch_mul32(q, zero + m[j]) + y + carry;
+      slowlib_fbig__batch_store(slowlib_fbig__row(t, j - 1), acc);
+      carry = acc >> slowlib_fbig_part_bits;
+    }
+    slowlib_fbig__batch_load(y, slowlib_fbig__row(t, n));
+    acc = y + carry;
+    slowlib_fbig__batch_store(slowlib_fbig__row(t, n - 1), acc);
+    acc = top + (acc >> slowlib_fbig_part_bits);
+    slowlib_fbig__batch_store(slowlib_fbig__row(t, n), acc);
+  }
+
+  /* t < 2m: out = t - m, unless that borrows */
+  borrow = zero;
+  for (j = 0; j < n; j++) {
+    slowlib_fbig__batch_load(y, slowlib_fbig__row(t, j));
+    acc = y - m[j] - borrow;
+    slowlib_fbig__batch_store(slowlib_fbig__row(out, j), acc);
+    borrow = acc >> (2 * slowlib_fbig_part_bits - 1);
+  }
+  slowlib_fbig__batch_load(y, slowlib_fbig__row(t, n));
+  keep = zero - ((y - borrow) >> (2 * slowlib_fbig_part_bits - 1));
+  for (j = 0; j < n; j++) {
+    slowlib_fbig__batch_load(x, slowlib_fbig__row(out, j));
+    slowlib_fbig__batch_load(y, slowlib_fbig__row(t, j));
+    acc = (y & keep) | (x & ~keep);
+    slowlib_fbig__batch_store(slowlib_fbig__row(out, j), acc);
+  }
+}
+
+#else
+
+/* one lane at a time, with the single-number kernels */
+
+static inline void slowlib_fbig__batch_lane_get(slowlib_fbig_part* x,
+                                                slowlib_fbig_part const* batch,
+                                                size_t np,
+                                                size_t lane)
+{
+  size_t i;
+  for (i = 0; i < np; i++)
+    x[i] = batch[i * SLOWLIBS_FBIG_BATCH_LANES + lane];
+}
+
+static inline void slowlib_fbig__batch_lane_set(slowlib_fbig_part* batch,
+                                                slowlib_fbig_part const* x,
+                                                size_t np,
+                                                size_t lane)
+{
+  size_t i;
+  for (i = 0; i < np; i++)
+    batch[i * SLOWLIBS_FBIG_BATCH_LANES + lane] = x[i];
+}
+
+static inline void slowlib_fbig__batch_add(slowlib_fbig_part* out,
+                                           size_t no,
+                                           slowlib_fbig_part const* a,
+                                           size_t na,
+                                           slowlib_fbig_part const* b,
+                                           size_t nb)
+{
+  slowlib_fbig_double_part acc;
+  slowlib_fbig_part carry;
+  size_t i, l;
+  for (l = 0; l < SLOWLIBS_FBIG_BATCH_LANES; l++) {
+    carry = 0;
+    for (i = 0; i < no; i++) {
+      acc = (slowlib_fbig_double_part)carry +
+            ((i < na) ? a[i * SLOWLIBS_FBIG_BATCH_LANES + l] : 0) +
+            ((i < nb) ? b[i * SLOWLIBS_FBIG_BATCH_LANES + l] : 0);
+      out[i * SLOWLIBS_FBIG_BATCH_LANES + l] = (slowlib_fbig_part)acc;
+      carry = (slowlib_fbig_part)(acc >> slowlib_fbig_part_bits);
+    }
+  }
+}
+
+/* t needs 2 (na + nb) parts */
+static inline void slowlib_fbig__batch_mul_t(slowlib_fbig_part* out,
+                                             slowlib_fbig_part const* a,
+                                             size_t na,
+                                             slowlib_fbig_part const* b,
+                                             size_t nb,
+                                             slowlib_fbig_part* t)
+{
+  size_t l;
+  for (l = 0; l < SLOWLIBS_FBIG_BATCH_LANES; l++) {
+    slowlib_fbig__batch_lane_get(t, a, na, l);
+    slowlib_fbig__batch_lane_get(&t[na], b, nb, l);
+    slowlib_fbig__mul_n(&t[na + nb], t, na, &t[na], nb);
+    slowlib_fbig__batch_lane_set(out, &t[na + nb], na + nb, l);
+  }
+}
+
+/* t needs 5 n + 2 parts */
+static inline void slowlib_fbig__batch_mont_mul(slowlib_fbig_part* out,
+                                                slowlib_fbig_part const* a,
+                                                slowlib_fbig_part const* b,
+                                                slowlib_fbig_part const* m,
+                                                slowlib_fbig_part minv,
+                                                size_t n,
+                                                slowlib_fbig_part* t)
+{
+  size_t l;
+  for (l = 0; l < SLOWLIBS_FBIG_BATCH_LANES; l++) {
+    slowlib_fbig__batch_lane_get(t, a, n, l);
+    slowlib_fbig__batch_lane_get(&t[n], b, n, l);
+    slowlib_fbig__mont_mul(&t[2 * n], t, &t[n], m, minv, n, &t[3 * n]);
+    slowlib_fbig__batch_lane_set(out, &t[2 * n], n, l);
+  }
+}
+
+#endif
+
+/* out[k] = a[k] + b[k], for the first nbatches batches */
+#define slowlib_fbig_batch_add(out, a, b, nbatches)                          \
+  do {                                                                       \
+    slowlib_fbig_static_assert(                                              \
+        sizeof((out)[0]) >= sizeof((a)[0]) &&                                \
+            sizeof((out)[0]) >= sizeof((b)[0]),                              \
+        out_too_small);                                                      \
+    for (size_t _k = 0; _k < (nbatches); _k++)                               \
+      slowlib_fbig__batch_add(                                               \
+          &(out)[_k][0][0], slowlib_fbig_batch_np((out)), &(a)[_k][0][0],    \
+          slowlib_fbig_batch_np((a)), &(b)[_k][0][0],                        \
+          slowlib_fbig_batch_np((b)));                                       \
+  } while (0)
+
+#ifdef SLOWLIBS_FBIG__BATCH_SIMD
+#define slowlib_fbig__batch_mul_any(out, a, na, b, nb, t) \
+  ((void)(t), slowlib_fbig__batch_mul((out), (a), (na), (b), (nb)))
+#else
+#define slowlib_fbig__batch_mul_any(out, a, na, b, nb, t) \
+  slowlib_fbig__batch_mul_t((out), (a), (na), (b), (nb), (t))
+#endif
+
+/* out[k] = a[k] * b[k], for the first nbatches batches */
+#define slowlib_fbig_batch_mul(out, a, b, nbatches)                          \
+  do {                                                                       \
+    size_t const _na = slowlib_fbig_batch_np((a));                           \
+    size_t const _nb = slowlib_fbig_batch_np((b));                           \
+    slowlib_fbig_part _p[(slowlib_fbig_batch_np((a)) +                       \
+                          slowlib_fbig_batch_np((b))) *                      \
+                         SLOWLIBS_FBIG_BATCH_LANES];                         \
+    slowlib_fbig_part _t[2 * (slowlib_fbig_batch_np((a)) +                   \
+                              slowlib_fbig_batch_np((b)))];                  \
+    slowlib_fbig_static_assert(sizeof((out)[0]) >=                           \
+                                   sizeof((a)[0]) + sizeof((b)[0]),          \
+                               out_too_small);                               \
+    for (size_t _k = 0; _k < (nbatches); _k++) {                             \
+      slowlib_fbig__batch_mul_any(_p, &(a)[_k][0][0], _na, &(b)[_k][0][0],   \
+                                  _nb, _t);                                  \
+      for (size_t _i = 0; _i < slowlib_fbig_batch_np((out)); _i++)           \
+        for (size_t _l = 0; _l < SLOWLIBS_FBIG_BATCH_LANES; _l++)            \
+          (out)[_k][_i][_l] =                                                \
+              (_i < _na + _nb) ? _p[_i * SLOWLIBS_FBIG_BATCH_LANES + _l] : 0; \
+    }                                                                        \
+  } while (0)
+
+/* out[k] = a[k] * b[k] / R mod m, for the first nbatches batches
+ *
+ * All numbers share the modulus of ctx (see slowlib_fbig_mont_ctx),
+ * and have to be smaller than it. */
+#define slowlib_fbig_batch_mont_mul(out, a, b, ctx, nbatches)                \
+  do {                                                                       \
+    slowlib_fbig_part                                                        \
+        _t[(5 * (sizeof((ctx).m) / sizeof(slowlib_fbig_part)) + 2) *        \
+           SLOWLIBS_FBIG_BATCH_LANES];                                       \
+    slowlib_fbig_static_assert(                                              \
+        sizeof((out)[0]) ==                                                  \
+                sizeof((ctx).m) * SLOWLIBS_FBIG_BATCH_LANES &&               \
+            sizeof((a)[0]) == sizeof((ctx).m) * SLOWLIBS_FBIG_BATCH_LANES && \
+            sizeof((b)[0]) == sizeof((ctx).m) * SLOWLIBS_FBIG_BATCH_LANES,   \
+        width_mismatch);                                                     \
+    for (size_t _k = 0; _k < (nbatches); _k++)                               \
+      slowlib_fbig__batch_mont_mul(&(out)[_k][0][0], &(a)[_k][0][0],         \
+                                   &(b)[_k][0][0], (ctx).m, (ctx).minv,      \
+                                   slowlib_fbig_np((ctx).m), _t);            \
+  } while (0)
+
 #endif
@@ -0,0 +1,527 @@
+/*
+ * Copyright (c) 2026 Alexander Nutz
+ * 0BSD licensed, see below documentation
+ *
+ * Latest version can be found at:
+ * https://git.vxcc.dev/alexander.nutz/slow-libs
+ *
+ *
+ * ======== GF(2^255 - 19) field arithmetic ========
+ *
+ * The field of Curve25519. Specialized version of what
+ * slowlib_fbig_reduce_pm(out, a, 255, 19) does generically.
+ *
+ * Elements are stored in 5 limbs of 51 bits, or, without 128-bit integers,
+ * in 10 signed limbs of alternating 26 and 25 bits.
+ * Carries are lazy: add and sub do not carry, and the results can be directly
+ * used as inputs to mul and sqr again.
+ * Only tobytes fully reduces.
+ *
+ * Security considerations:
+ * - timing attacks:
+ *   All functions are branch-free and do not index memory based on secret data.
+ *
+ *
+ * Configuration options:
+ * - SLOWCRYPT_GF25519_USE_32BIT
+ *     use the 10 limb implementation even if 128-bit integers are available
+ *
+ *
+ * Compatibility:
+ *   requires only a C99 compiler.
+ */
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#ifndef SLOWCRYPT_GF25519_H
+#define SLOWCRYPT_GF25519_H
+
+#include <stdint.h>
+
+#if defined(__SIZEOF_INT128__) && !defined(SLOWCRYPT_GF25519_USE_32BIT)
+#define SLOWCRYPT_GF25519_51
+#endif
+
+#ifdef SLOWCRYPT_GF25519_51
+
+#define SLOWCRYPT_GF25519_LIMBS 5
+
+__extension__ typedef unsigned __int128 slowcrypt_gf25519_u128;
+
+typedef struct
+{
+  uint64_t v[5];
+} slowcrypt_gf25519;
+
+#define SLOWCRYPT_GF25519_MASK51 (((uint64_t)1 << 51) - 1)
+
+static inline unsigned slowcrypt_gf25519_limb_bits(unsigned i)
+{
+  (void)i;
+  return 51;
+}
+
+/* out = a + b */
+static inline void slowcrypt_gf25519_add(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  int i;
+  for (i = 0; i < 5; i++)
+    out->v[i] = a->v[i] + b->v[i];
+}
+
+/* out = a - b
+ * b must come directly out of mul, sqr or mul_small (limbs < 2^52) */
+static inline void slowcrypt_gf25519_sub(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  /* + 2p, so that no limb underflows */
+  out->v[0] = (a->v[0] + 0xfffffffffffdaULL) - b->v[0];
+  out->v[1] = (a->v[1] + 0xffffffffffffeULL) - b->v[1];
+  out->v[2] = (a->v[2] + 0xffffffffffffeULL) - b->v[2];
+  out->v[3] = (a->v[3] + 0xffffffffffffeULL) - b->v[3];
+  out->v[4] = (a->v[4] + 0xffffffffffffeULL) - b->v[4];
+}
+
+static inline void slowcrypt_gf25519_carry_wide(
+    slowcrypt_gf25519* out,
+    slowcrypt_gf25519_u128 const r[5])
+{
+  slowcrypt_gf25519_u128 r1 = r[1], r2 = r[2], r3 = r[3], r4 = r[4];
+  uint64_t r0, c;
+
+  r0 = (uint64_t)r[0] & SLOWCRYPT_GF25519_MASK51;
+  r1 += (uint64_t)(r[0] >> 51);
+  out->v[1] = (uint64_t)r1 & SLOWCRYPT_GF25519_MASK51;
+  r2 += (uint64_t)(r1 >> 51);
+  out->v[2] = (uint64_t)r2 & SLOWCRYPT_GF25519_MASK51;
+  r3 += (uint64_t)(r2 >> 51);
+  out->v[3] = (uint64_t)r3 & SLOWCRYPT_GF25519_MASK51;
+  r4 += (uint64_t)(r3 >> 51);
+  out->v[4] = (uint64_t)r4 & SLOWCRYPT_GF25519_MASK51;
+  r0 += (uint64_t)(r4 >> 51) * 19;
+  c = r0 >> 51;
+  out->v[0] = r0 & SLOWCRYPT_GF25519_MASK51;
+  out->v[1] += c;
+}
+
+/* out = a * b */
+static inline void slowcrypt_gf25519_mul(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  uint64_t const a0 = a->v[0], a1 = a->v[1], a2 = a->v[2], a3 = a->v[3],
+                 a4 = a->v[4];
+  uint64_t const b0 = b->v[0], b1 = b->v[1], b2 = b->v[2], b3 = b->v[3],
+                 b4 = b->v[4];
+  uint64_t const b1_19 = b1 * 19, b2_19 = b2 * 19, b3_19 = b3 * 19,
+                 b4_19 = b4 * 19;
+  slowcrypt_gf25519_u128 r[5];
+
+  /* limbs above 2^255 wrap around as * 19 */
+  r[0] = (slowcrypt_gf25519_u128)a0 * b0 + (slowcrypt_gf25519_u128)a1 * b4_19 +
+         (slowcrypt_gf25519_u128)a2 * b3_19 +
+         (slowcrypt_gf25519_u128)a3 * b2_19 +
+         (slowcrypt_gf25519_u128)a4 * b1_19;
+  r[1] = (slowcrypt_gf25519_u128)a0 * b1 + (slowcrypt_gf25519_u128)a1 * b0 +
+         (slowcrypt_gf25519_u128)a2 * b4_19 +
+         (slowcrypt_gf25519_u128)a3 * b3_19 +
+         (slowcrypt_gf25519_u128)a4 * b2_19;
+  r[2] = (slowcrypt_gf25519_u128)a0 * b2 + (slowcrypt_gf25519_u128)a1 * b1 +
+         (slowcrypt_gf25519_u128)a2 * b0 +
+         (slowcrypt_gf25519_u128)a3 * b4_19 +
+         (slowcrypt_gf25519_u128)a4 * b3_19;
+  r[3] = (slowcrypt_gf25519_u128)a0 * b3 + (slowcrypt_gf25519_u128)a1 * b2 +
+         (slowcrypt_gf25519_u128)a2 * b1 + (slowcrypt_gf25519_u128)a3 * b0 +
+         (slowcrypt_gf25519_u128)a4 * b4_19;
+  r[4] = (slowcrypt_gf25519_u128)a0 * b4 + (slowcrypt_gf25519_u128)a1 * b3 +
+         (slowcrypt_gf25519_u128)a2 * b2 + (slowcrypt_gf25519_u128)a3 * b1 +
+         (slowcrypt_gf25519_u128)a4 * b0;
+
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* out = a * a */
+static inline void slowcrypt_gf25519_sqr(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a)
+{
+  uint64_t const a0 = a->v[0], a1 = a->v[1], a2 = a->v[2], a3 = a->v[3],
+                 a4 = a->v[4];
+  uint64_t const a0_2 = a0 * 2, a1_2 = a1 * 2, a1_38 = a1 * 38,
+                 a2_38 = a2 * 38, a3_38 = a3 * 38, a3_19 = a3 * 19,
+                 a4_19 = a4 * 19;
+  slowcrypt_gf25519_u128 r[5];
+
+  r[0] = (slowcrypt_gf25519_u128)a0 * a0 +
+         (slowcrypt_gf25519_u128)a1_38 * a4 +
+         (slowcrypt_gf25519_u128)a2_38 * a3;
+  r[1] = (slowcrypt_gf25519_u128)a0_2 * a1 +
+         (slowcrypt_gf25519_u128)a2_38 * a4 +
+         (slowcrypt_gf25519_u128)a3_19 * a3;
+  r[2] = (slowcrypt_gf25519_u128)a0_2 * a2 + (slowcrypt_gf25519_u128)a1 * a1 +
+         (slowcrypt_gf25519_u128)a3_38 * a4;
+  r[3] = (slowcrypt_gf25519_u128)a0_2 * a3 +
+         (slowcrypt_gf25519_u128)a1_2 * a2 +
+         (slowcrypt_gf25519_u128)a4_19 * a4;
+  r[4] = (slowcrypt_gf25519_u128)a0_2 * a4 +
+         (slowcrypt_gf25519_u128)a1_2 * a3 + (slowcrypt_gf25519_u128)a2 * a2;
+
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* out = a * b, with b < 2^32 */
+static inline void slowcrypt_gf25519_mul_small(slowcrypt_gf25519* out,
+                                               slowcrypt_gf25519 const* a,
+                                               uint32_t b)
+{
+  slowcrypt_gf25519_u128 r[5];
+  int i;
+  for (i = 0; i < 5; i++)
+    r[i] = (slowcrypt_gf25519_u128)a->v[i] * b;
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* fully reduce, limbs are exactly 51 bits afterwards */
+static inline void slowcrypt_gf25519_canonical(slowcrypt_gf25519* a)
+{
+  uint64_t q, c;
+  int i;
+
+  /* carry, so that every limb is below 2^51 and a < 2^255 + small */
+  for (i = 0; i < 2; i++) {
+    c = a->v[0] >> 51;
+    a->v[0] &= SLOWCRYPT_GF25519_MASK51;
+    a->v[1] += c;
+    c = a->v[1] >> 51;
+    a->v[1] &= SLOWCRYPT_GF25519_MASK51;
+    a->v[2] += c;
+    c = a->v[2] >> 51;
+    a->v[2] &= SLOWCRYPT_GF25519_MASK51;
+    a->v[3] += c;
+    c = a->v[3] >> 51;
+    a->v[3] &= SLOWCRYPT_GF25519_MASK51;
+    a->v[4] += c;
+    c = a->v[4] >> 51;
+    a->v[4] &= SLOWCRYPT_GF25519_MASK51;
+    a->v[0] += c * 19;
+  }
+
+  /* q = 1 if a >= p */
+  q = (a->v[0] + 19) >> 51;
+  q = (a->v[1] + q) >> 51;
+  q = (a->v[2] + q) >> 51;
+  q = (a->v[3] + q) >> 51;
+  q = (a->v[4] + q) >> 51;
+
+  /* a - q * p = a + 19 q - q 2^255 */
+  a->v[0] += 19 * q;
+  c = a->v[0] >> 51;
+  a->v[0] &= SLOWCRYPT_GF25519_MASK51;
+  a->v[1] += c;
+  c = a->v[1] >> 51;
+  a->v[1] &= SLOWCRYPT_GF25519_MASK51;
+  a->v[2] += c;
+  c = a->v[2] >> 51;
+  a->v[2] &= SLOWCRYPT_GF25519_MASK51;
+  a->v[3] += c;
+  c = a->v[3] >> 51;
+  a->v[3] &= SLOWCRYPT_GF25519_MASK51;
+  a->v[4] += c;
+  a->v[4] &= SLOWCRYPT_GF25519_MASK51;
+}
+
+#else
+
+#define SLOWCRYPT_GF25519_LIMBS 10
+
+typedef struct
+{
+  int32_t v[10];
+} slowcrypt_gf25519;
+
+/* even limbs have 26 bits, odd limbs 25 */
+static inline unsigned slowcrypt_gf25519_limb_bits(unsigned i)
+{
+  return (i & 1) ? 25 : 26;
+}
+
+/* out = a + b */
+static inline void slowcrypt_gf25519_add(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  int i;
+  for (i = 0; i < 10; i++)
+    out->v[i] = a->v[i] + b->v[i];
+}
+
+/* out = a - b (limbs are signed) */
+static inline void slowcrypt_gf25519_sub(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  int i;
+  for (i = 0; i < 10; i++)
+    out->v[i] = a->v[i] - b->v[i];
+}
+
+static inline void slowcrypt_gf25519_carry_wide(slowcrypt_gf25519* out,
+                                                int64_t r[10])
+{
+  int64_t c;
+  unsigned bits;
+  int i;
+
+  /* round to nearest, so that limbs stay small in both directions */
+  for (i = 0; i < 10; i++) {
+    bits = slowcrypt_gf25519_limb_bits(i);
+    c = (r[i] + ((int64_t)1 << (bits - 1))) >> bits;
+    r[i] -= c * ((int64_t)1 << bits);
+    if (i == 9)
+      r[0] += c * 19;
+    else
+      r[i + 1] += c;
+  }
+  c = (r[0] + ((int64_t)1 << 25)) >> 26;
+  r[0] -= c * ((int64_t)1 << 26);
+  r[1] += c;
+
+  for (i = 0; i < 10; i++)
+    out->v[i] = (int32_t)r[i];
+}
+
+/* out = a * b */
+static inline void slowcrypt_gf25519_mul(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a,
+                                         slowcrypt_gf25519 const* b)
+{
+  int64_t r[10] = {0}, b19[10], ai, ai2;
+  int i, j;
+
+  /* limbs above 2^255 wrap around as * 19 */
+  for (j = 0; j < 10; j++)
+    b19[j] = (int64_t)b->v[j] * 19;
+
+  for (i = 0; i < 10; i++) {
+    ai = a->v[i];
+    /* two 25 bit limbs: position is one bit off */
+    ai2 = (i & 1) ? ai * 2 : ai;
+    for (j = 0; j < 10 - i; j += 2)
+      r[i + j] += ai * b->v[j];
+    for (j = 1; j < 10 - i; j += 2)
+      r[i + j] += ai2 * b->v[j];
+    for (j = 10 - i + ((10 - i) & 1); j < 10; j += 2)
+      r[i + j - 10] += ai * b19[j];
+    for (j = 10 - i + !((10 - i) & 1); j < 10; j += 2)
+      r[i + j - 10] += ai2 * b19[j];
+  }
+
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* out = a * a */
+static inline void slowcrypt_gf25519_sqr(slowcrypt_gf25519* out,
+                                         slowcrypt_gf25519 const* a)
+{
+  int64_t r[10] = {0}, a19[10], ai, ai2;
+  int i, j;
+
+  for (j = 0; j < 10; j++)
+    a19[j] = (int64_t)a->v[j] * 19;
+
+  /* a[i] * a[j] and a[j] * a[i] only computed once */
+  for (i = 0; i < 10; i++) {
+    ai = a->v[i];
+    if (2 * i < 10)
+      r[2 * i] += ((i & 1) ? ai * 2 : ai) * ai;
+    else
+      r[2 * i - 10] += ((i & 1) ? ai * 2 : ai) * a19[i];
+
+    ai2 = ai * 2;
+    for (j = i + 1; j < 10; j++) {
+      if (i + j < 10)
+        r[i + j] += ((i & j & 1) ? ai2 * 2 : ai2) * a->v[j];
+      else
+        r[i + j - 10] += ((i & j & 1) ? ai2 * 2 : ai2) * a19[j];
+    }
+  }
+
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* out = a * b, with b < 2^24 */
+static inline void slowcrypt_gf25519_mul_small(slowcrypt_gf25519* out,
+                                               slowcrypt_gf25519 const* a,
+                                               uint32_t b)
+{
+  int64_t r[10];
+  int i;
+  for (i = 0; i < 10; i++)
+    r[i] = (int64_t)a->v[i] * (int64_t)b;
+  slowcrypt_gf25519_carry_wide(out, r);
+}
+
+/* fully reduce, limbs are exactly 26 / 25 bits afterwards */
+static inline void slowcrypt_gf25519_canonical(slowcrypt_gf25519* a)
+{
+  int64_t h[10], q, c;
+  unsigned bits;
+  int i;
+
+  for (i = 0; i < 10; i++)
+    h[i] = a->v[i];
+
+  /* q = floor(a / p), which is 0 or 1 for carried (small) limbs */
+  q = (19 * h[9] + ((int64_t)1 << 24)) >> 25;
+  for (i = 0; i < 10; i++)
+    q = (h[i] + q) >> slowcrypt_gf25519_limb_bits(i);
+
+  /* a - q * p = a + 19 q - q 2^255 */
+  h[0] += 19 * q;
+  for (i = 0; i < 9; i++) {
+    bits = slowcrypt_gf25519_limb_bits(i);
+    c = h[i] >> bits;
+    h[i + 1] += c;
+    h[i] -= c * ((int64_t)1 << bits);
+  }
+  h[9] &= ((int64_t)1 << 25) - 1;
+
+  for (i = 0; i < 10; i++)
+    a->v[i] = (int32_t)h[i];
+}
+
+#endif
+
+static inline void slowcrypt_gf25519_zero(slowcrypt_gf25519* out)
+{
+  int i;
+  for (i = 0; i < SLOWCRYPT_GF25519_LIMBS; i++)
+    out->v[i] = 0;
+}
+
+static inline void slowcrypt_gf25519_one(slowcrypt_gf25519* out)
+{
+  slowcrypt_gf25519_zero(out);
+  out->v[0] = 1;
+}
+
+/* swaps a and b if swap is 1, without branching */
+static inline void slowcrypt_gf25519_cswap(slowcrypt_gf25519* a,
+                                           slowcrypt_gf25519* b,
+                                           unsigned swap)
+{
+#ifdef SLOWCRYPT_GF25519_51
+  uint64_t const mask = (uint64_t)0 - swap;
+  uint64_t t;
+#else
+  int32_t const mask = -(int32_t)swap;
+  int32_t t;
+#endif
+  int i;
+  for (i = 0; i < SLOWCRYPT_GF25519_LIMBS; i++) {
+    t = mask & (a->v[i] ^ b->v[i]);
+    a->v[i] ^= t;
+    b->v[i] ^= t;
+  }
+}
+
+/* out = a^(2^n) */
+static inline void slowcrypt_gf25519_sqr_n(slowcrypt_gf25519* out,
+                                           slowcrypt_gf25519 const* a,
+                                           int n)
+{
+  int i;
+  slowcrypt_gf25519_sqr(out, a);
+  for (i = 1; i < n; i++)
+    slowcrypt_gf25519_sqr(out, out);
+}
+
+/* out = a^(p - 2) = 1 / a, (0 for a = 0) */
+static inline void slowcrypt_gf25519_invert(slowcrypt_gf25519* out,
+                                            slowcrypt_gf25519 const* a)
+{
+  slowcrypt_gf25519 t0, t1, t2, t3;
+
+  slowcrypt_gf25519_sqr(&t0, a);          /* 2 */
+  slowcrypt_gf25519_sqr_n(&t1, &t0, 2);   /* 8 */
+  slowcrypt_gf25519_mul(&t1, a, &t1);     /* 9 */
+  slowcrypt_gf25519_mul(&t0, &t0, &t1);   /* 11 */
+  slowcrypt_gf25519_sqr(&t2, &t0);        /* 22 */
+  slowcrypt_gf25519_mul(&t1, &t1, &t2);   /* 2^5 - 1 */
+  slowcrypt_gf25519_sqr_n(&t2, &t1, 5);   /* 2^10 - 2^5 */
+  slowcrypt_gf25519_mul(&t1, &t2, &t1);   /* 2^10 - 1 */
+  slowcrypt_gf25519_sqr_n(&t2, &t1, 10);  /* 2^20 - 2^10 */
+  slowcrypt_gf25519_mul(&t2, &t2, &t1);   /* 2^20 - 1 */
+  slowcrypt_gf25519_sqr_n(&t3, &t2, 20);  /* 2^40 - 2^20 */
+  slowcrypt_gf25519_mul(&t2, &t3, &t2);   /* 2^40 - 1 */
+  slowcrypt_gf25519_sqr_n(&t2, &t2, 10);  /* 2^50 - 2^10 */
+  slowcrypt_gf25519_mul(&t1, &t2, &t1);   /* 2^50 - 1 */
+  slowcrypt_gf25519_sqr_n(&t2, &t1, 50);  /* 2^100 - 2^50 */
+  slowcrypt_gf25519_mul(&t2, &t2, &t1);   /* 2^100 - 1 */
+  slowcrypt_gf25519_sqr_n(&t3, &t2, 100); /* 2^200 - 2^100 */
+  slowcrypt_gf25519_mul(&t2, &t3, &t2);   /* 2^200 - 1 */
+  slowcrypt_gf25519_sqr_n(&t2, &t2, 50);  /* 2^250 - 2^50 */
+  slowcrypt_gf25519_mul(&t1, &t2, &t1);   /* 2^250 - 1 */
+  slowcrypt_gf25519_sqr_n(&t1, &t1, 5);   /* 2^255 - 2^5 */
+  slowcrypt_gf25519_mul(out, &t1, &t0);   /* 2^255 - 21 */
+}
+
+/* little endian, the top bit is ignored */
+static inline void slowcrypt_gf25519_frombytes(slowcrypt_gf25519* out,
+                                               uint8_t const in[32])
+{
+  uint64_t acc = 0;
+  unsigned acc_bits = 0, pos = 0, bits, i;
+
+  for (i = 0; i < SLOWCRYPT_GF25519_LIMBS; i++) {
+    bits = slowcrypt_gf25519_limb_bits(i);
+    while (acc_bits < bits) {
+      acc |= (uint64_t)(pos == 31 ? in[pos] & 0x7f : in[pos]) << acc_bits;
+      pos++;
+      acc_bits += 8;
+    }
+    out->v[i] = acc & (((uint64_t)1 << bits) - 1);
+    acc >>= bits;
+    acc_bits -= bits;
+  }
+}
+
+/* little endian, fully reduced */
+static inline void slowcrypt_gf25519_tobytes(uint8_t out[32],
+                                             slowcrypt_gf25519 const* a)
+{
+  slowcrypt_gf25519 t = *a;
+  uint64_t acc = 0;
+  unsigned acc_bits = 0, pos = 0, i;
+
+  slowcrypt_gf25519_canonical(&t);
+  for (i = 0; i < SLOWCRYPT_GF25519_LIMBS; i++) {
+    acc |= (uint64_t)t.v[i] << acc_bits;
+    acc_bits += slowcrypt_gf25519_limb_bits(i);
+    while (acc_bits >= 8) {
+      out[pos++] = (uint8_t)acc;
+      acc >>= 8;
+      acc_bits -= 8;
+    }
+  }
+  out[pos] = (uint8_t)acc;
+}
+
+#endif
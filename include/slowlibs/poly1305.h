@@ -234,14 +234,8 @@ slowcrypt_poly1305_next_block(slowcrypt_poly1305* p,
   slowlib_fbig_add(temp, p->acc, temp);
   slowlib_fbig_mul(p->prod, temp, p->r);
 
-  // (1 << 130) - 5
-  slowlib_fbig_const(136, P,
-                     {slowlib_fbig_const_part_u64(0xfffffffffffffffb),
-                      slowlib_fbig_const_part_u64(0xffffffffffffffff),
-                      slowlib_fbig_const_part_u64(0x3)});
-
-  slowlib_fbig_umod(p->prod, p->prod, P);
-  slowlib_fbig_trunc(p->acc, p->prod);
+  // mod (1 << 130) - 5
+  slowlib_fbig_reduce_pm(p->acc, p->prod, 130, 5);
 }
 
 SLOWCRYPT_POLY1305_FUNC void slowcrypt_timing_sensitive
@@ -71,6 +71,41 @@
 #define SLOWARR_CAP_FOR_FIRST_ELEM(T) (4) /* TODO: could do better */
 #endif
 
+#ifndef SLOWARR_SHOULD_SHRINK
+/** after removing: only shrink if less than a quarter is used,
+ * so that alternating push and pop doesn't reallocate every time */
+#define SLOWARR_SHOULD_SHRINK(T, len, cap) ((len) < ((cap) >> 2))
+#endif
+
+#ifndef SLOWARR_SHRINK_TO
+/** cap after an automatic shrink. leaves room to grow again */
+#define SLOWARR_SHRINK_TO(T, len)                                        \
+  ((len) < SLOWARR_CAP_FOR_FIRST_ELEM(T) ? SLOWARR_CAP_FOR_FIRST_ELEM(T) \
+                                         : (len) << 1)
+#endif
+
+#ifndef SLOWARR_ROUND_CAP
+/** every new cap goes through this. the default rounds the size in
+ * bytes up to a malloc-like size class, to use the slack of the block */
+#define SLOWARR_ROUND_CAP(T, cap) slowarr__round_cap(cap, sizeof(T))
+#endif
+
+/* 16 byte steps up to 64 bytes, then four classes per power of two,
+ * so at most 25% are wasted */
+static inline SLOWARR_SZT slowarr__round_cap(SLOWARR_SZT cap, SLOWARR_SZT elem)
+{
+  SLOWARR_SZT bytes = cap * elem, p = 16, step, rounded;
+  if (!cap || bytes / elem != cap)
+    return cap;
+  while (p <= bytes / 2)
+    p <<= 1;
+  step = p >> 2 < 16 ? 16 : p >> 2;
+  rounded = (bytes + step - 1) / step * step;
+  if (rounded < bytes)
+    return cap;
+  return rounded / elem;
+}
+
 /* TODO */
 #define SLOWARR_MANGLE(T) SLOWARR_NAMESPACE(T)
 #define SLOWARR_MANGLE_F(T, F) SLOWARR_NAMESPACE(T##__##F)
@@ -97,39 +132,546 @@
 #define SLOWARR__BORROWED (1 << 0) /** disable reallocation / freeing */
 #define SLOWARR__ZEROIZE (1 << 1)  /** for cryptography */
 
+/* ======== Allocators ========
+ *
+ * Arrays declared with SLOWARR_HeaderA(T) / SLOWARR_ImplA(T) allocate from
+ * `arr.alloc`, or with SLOWARR_REALLOC / SLOWARR_FREE if that is null.
+ *
+ * realloc(ctx, 0, 0, n) allocates, and realloc(ctx, p, old, 0) may return null.
+ * Sizes are always in bytes.
+ */
+typedef struct
+{
+  void* (*realloc)(void* ctx, void* ptr, SLOWARR_SZT old, SLOWARR_SZT news);
+  void (*free)(void* ctx, void* ptr, SLOWARR_SZT size);
+  void* ctx;
+} slowarr_allocator;
+
+/* ==== Arena ====
+ *
+ * Bump allocator: freeing single allocations does nothing
+ * (except for the last one), everything is freed at once by
+ * slowarr_arena_reset() or slowarr_arena_deinit().
+ * The most recent allocation can grow in place.
+ *
+ * Example:
+ *     slowarr_arena arena;
+ *     slowarr_allocator alloc;
+ *     slowarr_arena_init(&arena, 64 * 1024);
+ *     alloc = slowarr_arena_allocator(&arena);
+ *     for every request {
+ *       T(SLOWARR__A, int) arr = F(SLOWARR__A, int, make)(&alloc);
+ *       ...
+ *       slowarr_arena_reset(&arena);
+ *     }
+ *     slowarr_arena_deinit(&arena);
+ */
+typedef struct slowarr_arena_chunk
+{
+  struct slowarr_arena_chunk* next;
+  SLOWARR_SZT size, used;
+} slowarr_arena_chunk;
+
+typedef struct
+{
+  slowarr_arena_chunk* chunks; /* current chunk first */
+  SLOWARR_SZT chunk_size;
+  void* last; /* most recent allocation */
+} slowarr_arena;
+
+#define SLOWARR__ALIGN(n) (((n) + 15) & ~(SLOWARR_SZT)15)
+#define SLOWARR__ARENA_HDR SLOWARR__ALIGN(sizeof(slowarr_arena_chunk))
+
+static inline void slowarr_arena_init(slowarr_arena* arena,
+                                      SLOWARR_SZT chunk_size)
+{
+  arena->chunks = 0;
+  arena->chunk_size = chunk_size;
+  arena->last = 0;
+}
+
+/* frees all but the first chunk, and makes that one empty again */
+static inline void slowarr_arena_reset(slowarr_arena* arena)
+{
+  slowarr_arena_chunk *c, *next;
+  if (!arena->chunks)
+    return;
+  /* the first chunk is the newest: keep the oldest, which is the smallest */
+  for (c = arena->chunks; c->next; c = next) {
+    next = c->next;
+    SLOWARR_FREE(c, c->size);
+  }
+  c->used = SLOWARR__ARENA_HDR;
+  arena->chunks = c;
+  arena->last = 0;
+}
+
+static inline void slowarr_arena_deinit(slowarr_arena* arena)
+{
+  slowarr_arena_chunk *c, *next;
+  for (c = arena->chunks; c; c = next) {
+    next = c->next;
+    SLOWARR_FREE(c, c->size);
+  }
+  arena->chunks = 0;
+  arena->last = 0;
+}
+
+static inline void* slowarr_arena_alloc(slowarr_arena* arena, SLOWARR_SZT n)
+{
+  slowarr_arena_chunk* c = arena->chunks;
+  SLOWARR_SZT size;
+  void* p;
+
+  n = SLOWARR__ALIGN(n);
+  if (!c || c->size - c->used < n) {
+    size = arena->chunk_size;
+    if (size < SLOWARR__ARENA_HDR + n)
+      size = SLOWARR__ARENA_HDR + n;
+    c = (slowarr_arena_chunk*)SLOWARR_REALLOC((void*)0, 0, size);
+    if (!c)
+      return (void*)0;
+    c->next = arena->chunks;
+    c->size = size;
+    c->used = SLOWARR__ARENA_HDR;
+    arena->chunks = c;
+  }
+  p = (unsigned char*)c + c->used;
+  c->used += n;
+  arena->last = p;
+  return p;
+}
+
+static inline void* slowarr_arena__realloc(void* ctx,
+                                           void* ptr,
+                                           SLOWARR_SZT old,
+                                           SLOWARR_SZT news)
+{
+  slowarr_arena* arena = (slowarr_arena*)ctx;
+  slowarr_arena_chunk* c = arena->chunks;
+  unsigned char* n;
+
+  /* the last allocation can grow and shrink in place */
+  if (ptr && ptr == arena->last &&
+      (unsigned char*)ptr + SLOWARR__ALIGN(news) <=
+          (unsigned char*)c + c->size) {
+    c->used = (SLOWARR_SZT)((unsigned char*)ptr - (unsigned char*)c) +
+              SLOWARR__ALIGN(news);
+    return ptr;
+  }
+  if (news <= old)
+    return news ? ptr : (void*)0;
+
+  n = (unsigned char*)slowarr_arena_alloc(arena, news);
+  if (n && ptr)
+    SLOWARR_MEMMOVE(n, ptr, old);
+  return n;
+}
+
+static inline void slowarr_arena__free(void* ctx, void* ptr, SLOWARR_SZT size)
+{
+  slowarr_arena* arena = (slowarr_arena*)ctx;
+  (void)size;
+  /* give back the space of the last allocation */
+  if (ptr && ptr == arena->last) {
+    arena->chunks->used =
+        (SLOWARR_SZT)((unsigned char*)ptr - (unsigned char*)arena->chunks);
+    arena->last = 0;
+  }
+}
+
+static inline slowarr_allocator slowarr_arena_allocator(slowarr_arena* arena)
+{
+  slowarr_allocator a;
+  a.realloc = slowarr_arena__realloc;
+  a.free = slowarr_arena__free;
+  a.ctx = arena;
+  return a;
+}
+
+/* ==== Pool ====
+ *
+ * Size-class allocator: sizes are rounded up to a power of two
+ * from 16 to 2^(SLOWARR_POOL_CLASSES + 3) bytes, and freed blocks
+ * are kept in a free list per size class, for reuse by the next
+ * allocation of that class. Larger blocks use SLOWARR_REALLOC directly.
+ * Nothing is returned to the system before slowarr_pool_deinit().
+ *
+ * Not thread safe: use one per thread.
+ */
+#ifndef SLOWARR_POOL_CLASSES
+#define SLOWARR_POOL_CLASSES 9 /* up to 4 KiB */
+#endif
+
+typedef struct
+{
+  void* free[SLOWARR_POOL_CLASSES];
+  /* all blocks ever allocated, to free them in deinit */
+  void* blocks;
+} slowarr_pool;
+
+/* every block starts with this, the user pointer is after it */
+typedef struct
+{
+  void* next_block;
+  void* next_free;
+} slowarr_pool__hdr;
+
+#define SLOWARR__POOL_HDR SLOWARR__ALIGN(sizeof(slowarr_pool__hdr))
+
+/* size class index, or SLOWARR_POOL_CLASSES if too large */
+static inline unsigned slowarr_pool__class(SLOWARR_SZT n)
+{
+  unsigned c = 0;
+  while (c < SLOWARR_POOL_CLASSES && ((SLOWARR_SZT)16 << c) < n)
+    c++;
+  return c;
+}
+
+static inline void slowarr_pool_init(slowarr_pool* pool)
+{
+  unsigned i;
+  for (i = 0; i < SLOWARR_POOL_CLASSES; i++)
+    pool->free[i] = 0;
+  pool->blocks = 0;
+}
+
+static inline void slowarr_pool_deinit(slowarr_pool* pool)
+{
+  slowarr_pool__hdr* h = (slowarr_pool__hdr*)pool->blocks;
+  slowarr_pool__hdr* next;
+  for (; h; h = next) {
+    next = (slowarr_pool__hdr*)h->next_block;
+    SLOWARR_FREE(h, 0);
+  }
+  slowarr_pool_init(pool);
+}
+
+static inline void* slowarr_pool_alloc(slowarr_pool* pool, SLOWARR_SZT n)
+{
+  unsigned c = slowarr_pool__class(n);
+  slowarr_pool__hdr* h;
+
+  if (c == SLOWARR_POOL_CLASSES)
+    return SLOWARR_REALLOC((void*)0, 0, n);
+
+  if (pool->free[c]) {
+    h = (slowarr_pool__hdr*)pool->free[c];
+    pool->free[c] = h->next_free;
+  } else {
+    h = (slowarr_pool__hdr*)SLOWARR_REALLOC(
+        (void*)0, 0, SLOWARR__POOL_HDR + ((SLOWARR_SZT)16 << c));
+    if (!h)
+      return (void*)0;
+    h->next_block = pool->blocks;
+    pool->blocks = h;
+  }
+  return (unsigned char*)h + SLOWARR__POOL_HDR;
+}
+
+/* size has to be the size it was allocated with */
+static inline void slowarr_pool_free(slowarr_pool* pool,
+                                     void* ptr,
+                                     SLOWARR_SZT size)
+{
+  unsigned c = slowarr_pool__class(size);
+  slowarr_pool__hdr* h;
+
+  if (!ptr)
+    return;
+  if (c == SLOWARR_POOL_CLASSES) {
+    SLOWARR_FREE(ptr, size);
+    return;
+  }
+  h = (slowarr_pool__hdr*)((unsigned char*)ptr - SLOWARR__POOL_HDR);
+  h->next_free = pool->free[c];
+  pool->free[c] = h;
+}
+
+static inline void* slowarr_pool__realloc(void* ctx,
+                                          void* ptr,
+                                          SLOWARR_SZT old,
+                                          SLOWARR_SZT news)
+{
+  slowarr_pool* pool = (slowarr_pool*)ctx;
+  unsigned oc = slowarr_pool__class(old), nc = slowarr_pool__class(news);
+  void* n;
+
+  if (ptr && news == 0) {
+    slowarr_pool_free(pool, ptr, old);
+    return (void*)0;
+  }
+  if (ptr && oc == nc) {
+    if (oc == SLOWARR_POOL_CLASSES)
+      return SLOWARR_REALLOC(ptr, old, news);
+    return ptr;
+  }
+
+  n = slowarr_pool_alloc(pool, news);
+  if (n && ptr) {
+    SLOWARR_MEMMOVE(n, ptr, old < news ? old : news);
+    slowarr_pool_free(pool, ptr, old);
+  }
+  return n;
+}
+
+static inline void slowarr_pool__free(void* ctx, void* ptr, SLOWARR_SZT size)
+{
+  slowarr_pool_free((slowarr_pool*)ctx, ptr, size);
+}
+
+static inline slowarr_allocator slowarr_pool_allocator(slowarr_pool* pool)
+{
+  slowarr_allocator a;
+  a.realloc = slowarr_pool__realloc;
+  a.free = slowarr_pool__free;
+  a.ctx = pool;
+  return a;
+}
+
 #ifdef __cplusplus
-template <typename T>
+#include <new>
+#include <utility>
+#if __cplusplus >= 202002L
+#include <span>
+#endif
+
+#define SLOWARR__CAT_(a, b) a##b
+#define SLOWARR__CAT(a, b) SLOWARR__CAT_(a, b)
+#define SLOWARR_CXXT_OPS SLOWARR__CAT(SLOWARR_CXXT, _Ops)
+
+/* specialized by SLOWARR_Header(T), to find the C functions */
+template <typename E>
+struct SLOWARR_CXXT_OPS
+{
+};
+
+/* ==== C++ ====
+ *
+ * Owning wrapper around T(SLOWARR, E), with exactly the same layout:
+ * c() gives the C array to C code, and the (implicit) constructor from
+ * a C array takes ownership of it. Borrowed arrays are never freed.
+ *
+ * Elements are moved with SLOWARR_MEMMOVE, so E has to be trivially
+ * relocatable. Copies have to be made explicitly with clone().
+ * Requires C++11.
+ */
+template <typename E>
 struct SLOWARR_CXXT
 {
+  typedef SLOWARR_CXXT_OPS<E> Ops;
+  typedef typename Ops::C C;
+
+  C arr;
+
+  SLOWARR_CXXT()
+  {
+    SLOWARR_MEMZERO(&arr, sizeof(arr));
+  }
+  SLOWARR_CXXT(C const& a) : arr(a) {}
+  SLOWARR_CXXT(SLOWARR_CXXT&& o) noexcept : arr(o.arr)
+  {
+    SLOWARR_MEMZERO(&o.arr, sizeof(o.arr));
+  }
+  SLOWARR_CXXT& operator=(SLOWARR_CXXT&& o) noexcept
+  {
+    if (this != &o) {
+      reset();
+      arr = o.arr;
+      SLOWARR_MEMZERO(&o.arr, sizeof(o.arr));
+    }
+    return *this;
+  }
+  SLOWARR_CXXT(SLOWARR_CXXT const&) = delete;
+  SLOWARR_CXXT& operator=(SLOWARR_CXXT const&) = delete;
+  ~SLOWARR_CXXT()
+  {
+    reset();
+  }
+
+  SLOWARR_CXXT clone() const
+  {
+    SLOWARR_CXXT r;
+    /* a copy of a zeroize array has to be zeroized too */
+    r.arr.attr = (unsigned char)(arr.attr & ~SLOWARR__BORROWED);
+    r.reserve(size());
+    for (E const& e : *this)
+      r.emplace_back(e);
+    return r;
+  }
+
+  C* c()
+  {
+    return &arr;
+  }
+  /** gives up ownership */
+  C release()
+  {
+    C r = arr;
+    SLOWARR_MEMZERO(&arr, sizeof(arr));
+    return r;
+  }
+
+  E* data()
+  {
+    return arr.data;
+  }
+  E const* data() const
+  {
+    return arr.data;
+  }
+  E* begin()
+  {
+    return arr.data;
+  }
+  E* end()
+  {
+    return arr.data + arr.len;
+  }
+  E const* begin() const
+  {
+    return arr.data;
+  }
+  E const* end() const
+  {
+    return arr.data + arr.len;
+  }
+  E const* cbegin() const
+  {
+    return begin();
+  }
+  E const* cend() const
+  {
+    return end();
+  }
+  SLOWARR_SZT size() const
+  {
+    return arr.len;
+  }
+  SLOWARR_SZT length() const
+  {
+    return arr.len;
+  }
+  SLOWARR_SZT capacity() const
+  {
+    return arr.cap;
+  }
+  bool empty() const
+  {
+    return arr.len == 0;
+  }
+
+  /** fails if oob */
+  E& operator[](SLOWARR_SZT i)
+  {
+    SLOWARR_ASSERT_USER_ERROR(i < arr.len);
+    return arr.data[i];
+  }
+  E const& operator[](SLOWARR_SZT i) const
+  {
+    SLOWARR_ASSERT_USER_ERROR(i < arr.len);
+    return arr.data[i];
+  }
+
+  /** total capacity, like std::vector */
+  void reserve(SLOWARR_SZT num)
+  {
+    Ops::reserveTotal(&arr, num);
+  }
+
+  template <typename... Args>
+  E& emplace_back(Args&&... args)
+  {
+    /* args can reference elements, which move when growing */
+    if (arr.len == arr.cap) {
+      E tmp(std::forward<Args>(args)...);
+      return construct_back(std::move(tmp));
+    }
+    return construct_back(std::forward<Args>(args)...);
+  }
+  void push_back(E const& val)
+  {
+    emplace_back(val);
+  }
+  void push_back(E&& val)
+  {
+    emplace_back(std::move(val));
+  }
+  void pop_back()
+  {
+    SLOWARR_ASSERT_USER_ERROR(arr.len > 0);
+    if (!(arr.attr & SLOWARR__BORROWED))
+      arr.data[arr.len - 1].~E();
+    Ops::removeRange(&arr, arr.len - 1, 1);
+  }
+  void clear()
+  {
+    destroy();
+    Ops::removeRange(&arr, 0, arr.len);
+  }
+
+#if __cplusplus >= 202002L
+  operator std::span<E>()
+  {
+    return std::span<E>(arr.data, arr.len);
+  }
+  operator std::span<E const>() const
+  {
+    return std::span<E const>(arr.data, arr.len);
+  }
+#endif
+
+private:
+  template <typename... Args>
+  E& construct_back(Args&&... args)
+  {
+    E* p = Ops::pushRef(&arr);
+    /* not an element before it is constructed */
+    arr.len--;
+    new (p) E(std::forward<Args>(args)...);
+    arr.len++;
+    return *p;
+  }
+  void destroy()
+  {
+    SLOWARR_SZT i;
+    if (arr.attr & SLOWARR__BORROWED)
+      return;
+    for (i = 0; i < arr.len; i++)
+      arr.data[i].~E();
+  }
+  void reset()
+  {
+    destroy();
+    Ops::unsafeClear(&arr);
+  }
 };
 
-#define SLOWARR_CXX_HEADER(T)    \
-  template <>                    \
-  struct SLOWARR_CXXT<T>         \
-  {                              \
-    SLOWARR_MANGLE(T) arr;       \
-                                 \
-    T* begin()                   \
-    {                            \
-      return arr.data;           \
-    }                            \
-    T* cbegin() const            \
-    {                            \
-      return arr.data;           \
-    }                            \
-    T* cend() const              \
-    {                            \
-      return arr.data + arr.len; \
-    }                            \
-    T* end()                     \
-    {                            \
-      return cend();             \
-    }                            \
-    SLOWARR_SZT length() const   \
-    {                            \
-      return arr.len;            \
-    }                            \
-  };
+#define SLOWARR_CXX_HEADER(T)                                         \
+  template <>                                                         \
+  struct SLOWARR_CXXT_OPS<T>                                          \
+  {                                                                   \
+    typedef SLOWARR_MANGLE(T) C;                                      \
+                                                                      \
+    static void unsafeClear(C* arr)                                   \
+    {                                                                 \
+      SLOWARR_MANGLE_F(T, unsafeClear)(arr);                          \
+    }                                                                 \
+    static void reserveTotal(C* arr, SLOWARR_SZT num)                 \
+    {                                                                 \
+      SLOWARR_MANGLE_F(T, reserveTotal)(arr, num);                    \
+    }                                                                 \
+    static T* pushRef(C* arr)                                         \
+    {                                                                 \
+      return SLOWARR_MANGLE_F(T, pushRef)(arr);                       \
+    }                                                                 \
+    static void removeRange(C* arr, SLOWARR_SZT i, SLOWARR_SZT n)     \
+    {                                                                 \
+      SLOWARR_MANGLE_F(T, removeRange)(arr, i, n, (T*)0);             \
+    }                                                                 \
+  };                                                                  \
+  static_assert(sizeof(SLOWARR_CXXT<T>) == sizeof(SLOWARR_MANGLE(T)), \
+                "SlowArr has to have the layout of the C array");
 #else
 #define SLOWARR_CXX_HEADER(T) /**/
 #endif
@@ -145,147 +687,457 @@ static void SLOWARR___REQUIRE_SEMI(void) {}
 
 #define SLOWARR_REQUIRE_SEMI static void SLOWARR___REQUIRE_SEMI(void)
 
-#define SLOWARR_Header(T)                                                      \
-  SLOWARR_BEGINC                                                               \
-  /** usage: T(Arr,int) myarr = {0}; */                                        \
-  typedef struct                                                               \
-  {                                                                            \
-    SLOWARR_SZT cap, len;                                                      \
-    T* data;                                                                   \
-    unsigned char attr;                                                        \
-  } SLOWARR_MANGLE(T);                                                         \
-  SLOWARR_ENDC                                                                 \
-                                                                               \
-  SLOWARR_CXX_HEADER(T)                                                        \
-  SLOWARR_BEGINC                                                               \
-                                                                               \
+/* declarations shared by all array variants.
+ * A is the array type, FN(K, name) makes the function names */
+#define SLOWARR__DECL(T, K, A, FN)                                             \
   /** result can not be reallocated */                                         \
-  SLOWARR_FUNC SLOWARR_MANGLE(T)                                               \
-      SLOWARR_MANGLE_F(T, borrow)(T * data, SLOWARR_SZT sz);                   \
+  SLOWARR_FUNC A FN(K, borrow)(T * data, SLOWARR_SZT sz);                      \
+                                                                               \
+  /** the elements: use this instead of arr.data for SBO arrays */             \
+  SLOWARR_FUNC T* FN(K, ptr)(A * arr);                                         \
                                                                                \
   /** usage: G(Arr,int,unsafeClear)(&arr)                                      \
    * this is marked unsafe, because it assumes that the elements don't need    \
    * to be destroyed each */                                                   \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, unsafeClear)(SLOWARR_MANGLE(T) * arr); \
+  SLOWARR_FUNC void FN(K, unsafeClear)(A * arr);                               \
                                                                                \
   /** resize to smallest cap required to hold current elems */                 \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, shrink)(SLOWARR_MANGLE(T) * arr);      \
+  SLOWARR_FUNC void FN(K, shrink)(A * arr);                                    \
+                                                                               \
+  /** resize to hold at least max(len, cap) elems, if that is smaller */       \
+  SLOWARR_FUNC void FN(K, shrinkTo)(A * arr, SLOWARR_SZT cap);                 \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, reserveTotal)(SLOWARR_MANGLE(T) * arr, \
-                                                      SLOWARR_SZT num);        \
+  SLOWARR_FUNC void FN(K, reserveTotal)(A * arr, SLOWARR_SZT num);             \
                                                                                \
-  SLOWARR_FUNC T* SLOWARR_MANGLE_F(T, pushRef)(SLOWARR_MANGLE(T) * arr);       \
+  SLOWARR_FUNC T* FN(K, pushRef)(A * arr);                                     \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, push)(SLOWARR_MANGLE(T) * arr, T val); \
+  SLOWARR_FUNC void FN(K, push)(A * arr, T val);                               \
                                                                                \
   /** fails if oob */                                                          \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, remove)(SLOWARR_MANGLE(T) * arr,       \
-                                                T * out, SLOWARR_SZT i);       \
+  SLOWARR_FUNC void FN(K, remove)(A * arr, T * out, SLOWARR_SZT i);            \
                                                                                \
-  SLOWARR_FUNC T SLOWARR_MANGLE_F(T, pop)(SLOWARR_MANGLE(T) * arr);            \
+  /** O(1): moves the last element into the gap. fails if oob */               \
+  SLOWARR_FUNC void FN(K, swapRemove)(A * arr, T * out, SLOWARR_SZT i);        \
                                                                                \
-  SLOWARR_ENDC                                                                 \
-  SLOWARR_REQUIRE_SEMI
-
-/** call this only once in your program. call SLOWARR_Header(T) first */
-#define SLOWARR_Impl(T)                                                        \
-  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC T FN(K, pop)(A * arr);                                          \
+                                                                               \
+  /** make room for n more elements, growing by at least the growth rate */    \
+  SLOWARR_FUNC void FN(K, reserve)(A * arr, SLOWARR_SZT n);                    \
+                                                                               \
+  /** appends n uninitialized elements, and returns the first of them */       \
+  SLOWARR_FUNC T* FN(K, pushUninit)(A * arr, SLOWARR_SZT n);                   \
+                                                                               \
+  /** appends n elements, which may be elements of arr itself */               \
+  SLOWARR_FUNC void FN(K, pushN)(A * arr, T const* vals, SLOWARR_SZT n);       \
+                                                                               \
+  SLOWARR_FUNC void FN(K, appendArray)(A * arr, A const* other);               \
+                                                                               \
+  /** inserts before element i (i = len appends). fails if oob */              \
+  SLOWARR_FUNC void FN(K, insertAt)(A * arr, SLOWARR_SZT i, T val);            \
+                                                                               \
+  /** vals must not point into arr. fails if oob */                            \
+  SLOWARR_FUNC void FN(K, insertRange)(A * arr, SLOWARR_SZT i, T const* vals,  \
+                                       SLOWARR_SZT n);                         \
                                                                                \
+  /** removes n elements starting at i, and copies them to out,                \
+   * if it is not null. fails if oob */                                        \
+  SLOWARR_FUNC void FN(K, removeRange)(A * arr, SLOWARR_SZT i, SLOWARR_SZT n,  \
+                                       T * out);                               \
+                                                                               \
+  /** new elements are zeroed */                                               \
+  SLOWARR_FUNC void FN(K, resize)(A * arr, SLOWARR_SZT len);
+
+/* implementation shared by all array variants.
+ * REALLOC(arr, ptr, old, news) and FREE(arr, ptr, size) allocate memory,
+ * DATA(arr) and SETDATA(arr, ptr) access the elements,
+ * INLCAP(arr) is the number of elements that fit without allocating */
+#define SLOWARR__IMPL(T, K, A, FN, REALLOC, FREE, DATA, SETDATA, INLCAP)       \
   /** result can not be reallocated */                                         \
-  SLOWARR_FUNC SLOWARR_MANGLE(T)                                               \
-      SLOWARR_MANGLE_F(T, borrow)(T * data, SLOWARR_SZT sz)                    \
+  SLOWARR_FUNC A FN(K, borrow)(T * data, SLOWARR_SZT sz)                       \
   {                                                                            \
-    SLOWARR_MANGLE(T) arr;                                                     \
-    arr.data = data;                                                           \
+    A arr;                                                                     \
+    SLOWARR_MEMZERO(&arr, sizeof(arr));                                        \
+    SETDATA(&arr, data);                                                       \
     arr.cap = sz;                                                              \
     arr.len = sz;                                                              \
     arr.attr = SLOWARR__BORROWED;                                              \
     return arr;                                                                \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, unsafeClear)(SLOWARR_MANGLE(T) * arr)  \
+  SLOWARR_FUNC T* FN(K, ptr)(A * arr)                                          \
+  {                                                                            \
+    return DATA(arr);                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, unsafeClear)(A * arr)                                \
   {                                                                            \
-    if (arr->data)                                                             \
-      SLOWARR_FREE(arr->data, arr->cap);                                       \
-    arr->data = (T*)(void*)0;                                                  \
+    if (DATA(arr) && !(arr->attr & SLOWARR__BORROWED)) {                       \
+      FREE(arr, DATA(arr), arr->cap * sizeof(T));                              \
+    }                                                                          \
+    SETDATA(arr, (T*)(void*)0);                                                \
     arr->cap = 0;                                                              \
     arr->len = 0;                                                              \
     /* don't change attrs */                                                   \
   }                                                                            \
                                                                                \
-  /* TODO: could make this align the cap num for better perf */                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, shrink)(SLOWARR_MANGLE(T) * arr)       \
+  SLOWARR_FUNC void FN(K, shrink)(A * arr)                                     \
   {                                                                            \
+    FN(K, shrinkTo)(arr, 0);                                                   \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, shrinkTo)(A * arr, SLOWARR_SZT cap)                  \
+  {                                                                            \
+    void* n;                                                                   \
     if (arr->attr & SLOWARR__BORROWED)                                         \
       return;                                                                  \
                                                                                \
-    if (arr->len == arr->cap)                                                  \
+    if (cap < arr->len)                                                        \
+      cap = arr->len;                                                          \
+    cap = cap <= INLCAP(arr) ? INLCAP(arr) : SLOWARR_ROUND_CAP(T, cap);        \
+    if (cap >= arr->cap)                                                       \
       return;                                                                  \
     if (arr->attr & SLOWARR__ZEROIZE)                                          \
-      SLOWARR_MEMZERO(arr->data + arr->len,                                    \
+      SLOWARR_MEMZERO(DATA(arr) + arr->len,                                    \
                       (arr->cap - arr->len) * sizeof(T));                      \
-    arr->data = (T*)SLOWARR_REALLOC(arr->data, arr->cap * sizeof(T),           \
-                                    arr->len * sizeof(T));                     \
-    arr->cap = arr->len;                                                       \
+    if (!cap) {                                                                \
+      FREE(arr, DATA(arr), arr->cap * sizeof(T));                              \
+      SETDATA(arr, (T*)(void*)0);                                              \
+      arr->cap = 0;                                                            \
+      return;                                                                  \
+    }                                                                          \
+    n = REALLOC(arr, DATA(arr), arr->cap * sizeof(T), cap * sizeof(T));        \
+    /* keep the larger block if it can't be shrunk */                          \
+    if (!n)                                                                    \
+      return;                                                                  \
+    SETDATA(arr, (T*)n);                                                       \
+    arr->cap = cap;                                                            \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, reserveTotal)(SLOWARR_MANGLE(T) * arr, \
-                                                      SLOWARR_SZT num)         \
+  SLOWARR_FUNC void FN(K, reserveTotal)(A * arr, SLOWARR_SZT num)              \
   {                                                                            \
     void* n;                                                                   \
     if (num <= arr->cap)                                                       \
       return;                                                                  \
     SLOWARR_ASSERT_USER_ERROR(!(arr->attr & SLOWARR__BORROWED));               \
-    n = SLOWARR_REALLOC(arr->data, sizeof(T) * arr->cap, sizeof(T) * num);     \
+    num = num <= INLCAP(arr) ? INLCAP(arr) : SLOWARR_ROUND_CAP(T, num);        \
+    n = REALLOC(arr, DATA(arr), sizeof(T) * arr->cap, sizeof(T) * num);        \
     if (!n) {                                                                  \
       if (arr->attr & SLOWARR__ZEROIZE)                                        \
-        SLOWARR_MEMZERO(arr->data, arr->cap * sizeof(T));                      \
-      SLOWARR_FREE(arr->data, arr->cap * sizeof(T));                           \
+        SLOWARR_MEMZERO(DATA(arr), arr->cap * sizeof(T));                      \
+      FREE(arr, DATA(arr), arr->cap * sizeof(T));                              \
       SLOWARR_ON_MALLOC_FAIL(sizeof(T) * num);                                 \
     }                                                                          \
-    arr->data = (T*)n;                                                         \
+    SETDATA(arr, (T*)n);                                                       \
     arr->cap = num;                                                            \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC T* SLOWARR_MANGLE_F(T, pushRef)(SLOWARR_MANGLE(T) * arr)        \
+  SLOWARR_FUNC T* FN(K, pushRef)(A * arr)                                      \
   {                                                                            \
-    if (arr->cap == 0) {                                                       \
-      SLOWARR_MANGLE_F(T, reserveTotal)(arr, SLOWARR_CAP_FOR_FIRST_ELEM(T));   \
-    } else if (arr->len + 1 > arr->cap) {                                      \
-      SLOWARR_MANGLE_F(T, reserveTotal)                                        \
-      (arr, SLOWARR_GROWTH_RATE(T, arr->len));                                 \
-    }                                                                          \
-    return &arr->data[arr->len++];                                             \
+    FN(K, reserve)(arr, 1);                                                    \
+    return &DATA(arr)[arr->len++];                                             \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, push)(SLOWARR_MANGLE(T) * arr, T val)  \
+  SLOWARR_FUNC void FN(K, push)(A * arr, T val)                                \
   {                                                                            \
-    *SLOWARR_MANGLE_F(T, pushRef)(arr) = val;                                  \
+    *FN(K, pushRef)(arr) = val;                                                \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC void SLOWARR_MANGLE_F(T, remove)(SLOWARR_MANGLE(T) * arr,       \
-                                                T * out, SLOWARR_SZT i)        \
+  SLOWARR_FUNC void FN(K, remove)(A * arr, T * out, SLOWARR_SZT i)             \
   {                                                                            \
-    SLOWARR_SZT too_much;                                                      \
     SLOWARR_ASSERT_USER_ERROR(i < arr->len);                                   \
-    *out = arr->data[i];                                                       \
-    SLOWARR_MEMMOVE(&arr->data[i], &arr->data[i + 1],                          \
+    *out = DATA(arr)[i];                                                       \
+    SLOWARR_MEMMOVE(&DATA(arr)[i], &DATA(arr)[i + 1],                          \
                     sizeof(T) * (arr->len - (i + 1)));                         \
     arr->len -= 1;                                                             \
-    too_much = arr->cap - arr->len;                                            \
-    if (too_much > SLOWARR_GROWTH_RATE(T, arr->len)) {                         \
-      SLOWARR_MANGLE_F(T, shrink)(arr);                                        \
+    if (arr->attr & SLOWARR__ZEROIZE)                                          \
+      SLOWARR_MEMZERO(DATA(arr) + arr->len, sizeof(T));                        \
+    if (SLOWARR_SHOULD_SHRINK(T, arr->len, arr->cap)) {                        \
+      FN(K, shrinkTo)(arr, SLOWARR_SHRINK_TO(T, arr->len));                    \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, swapRemove)(A * arr, T * out, SLOWARR_SZT i)         \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(i < arr->len);                                   \
+    *out = DATA(arr)[i];                                                       \
+    arr->len -= 1;                                                             \
+    if (i != arr->len)                                                         \
+      DATA(arr)[i] = DATA(arr)[arr->len];                                      \
+    if (arr->attr & SLOWARR__ZEROIZE)                                          \
+      SLOWARR_MEMZERO(DATA(arr) + arr->len, sizeof(T));                        \
+    if (SLOWARR_SHOULD_SHRINK(T, arr->len, arr->cap)) {                        \
+      FN(K, shrinkTo)(arr, SLOWARR_SHRINK_TO(T, arr->len));                    \
     }                                                                          \
   }                                                                            \
                                                                                \
-  SLOWARR_FUNC T SLOWARR_MANGLE_F(T, pop)(SLOWARR_MANGLE(T) * arr)             \
+  SLOWARR_FUNC T FN(K, pop)(A * arr)                                           \
   {                                                                            \
     T temp;                                                                    \
-    SLOWARR_MANGLE_F(T, remove)(arr, &temp, arr->len - 1);                     \
+    FN(K, remove)(arr, &temp, arr->len - 1);                                   \
     return temp;                                                               \
   }                                                                            \
                                                                                \
-  SLOWARR_ENDC                                                                 \
+  SLOWARR_FUNC void FN(K, reserve)(A * arr, SLOWARR_SZT n)                     \
+  {                                                                            \
+    SLOWARR_SZT want = arr->len + n;                                           \
+    if (want <= arr->cap)                                                      \
+      return;                                                                  \
+    /* the first-element and growth rules only apply on the heap */            \
+    if (want <= INLCAP(arr))                                                   \
+      want = INLCAP(arr);                                                      \
+    else if (arr->cap == 0 && want < SLOWARR_CAP_FOR_FIRST_ELEM(T))            \
+      want = SLOWARR_CAP_FOR_FIRST_ELEM(T);                                    \
+    else if (want < SLOWARR_GROWTH_RATE(T, arr->len))                          \
+      want = SLOWARR_GROWTH_RATE(T, arr->len);                                 \
+    FN(K, reserveTotal)(arr, want);                                            \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* FN(K, pushUninit)(A * arr, SLOWARR_SZT n)                    \
+  {                                                                            \
+    T* first;                                                                  \
+    FN(K, reserve)(arr, n);                                                    \
+    first = DATA(arr) + arr->len;                                              \
+    arr->len += n;                                                             \
+    return first;                                                              \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, pushN)(A * arr, T const* vals, SLOWARR_SZT n)        \
+  {                                                                            \
+    SLOWARR_SZT self = arr->len;                                               \
+    if (!n)                                                                    \
+      return;                                                                  \
+    /* the source could move with the reallocation */                          \
+    if (DATA(arr) && vals >= DATA(arr) && vals < DATA(arr) + arr->len)         \
+      self = (SLOWARR_SZT)(vals - DATA(arr));                                  \
+    FN(K, reserve)(arr, n);                                                    \
+    if (self != arr->len)                                                      \
+      vals = DATA(arr) + self;                                                 \
+    SLOWARR_MEMMOVE(DATA(arr) + arr->len, (void*)(T*)vals, n * sizeof(T));     \
+    arr->len += n;                                                             \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, appendArray)(A * arr, A const* other)                \
+  {                                                                            \
+    FN(K, pushN)(arr, DATA(other), other->len);                                \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, insertAt)(A * arr, SLOWARR_SZT i, T val)             \
+  {                                                                            \
+    FN(K, insertRange)(arr, i, &val, 1);                                       \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, insertRange)(A * arr, SLOWARR_SZT i, T const* vals,  \
+                                       SLOWARR_SZT n)                          \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(i <= arr->len);                                  \
+    SLOWARR_ASSERT_USER_ERROR(!DATA(arr) || vals < DATA(arr) ||                \
+                              vals >= DATA(arr) + arr->len);                   \
+    if (!n)                                                                    \
+      return;                                                                  \
+    FN(K, reserve)(arr, n);                                                    \
+    SLOWARR_MEMMOVE(DATA(arr) + i + n, DATA(arr) + i,                          \
+                    (arr->len - i) * sizeof(T));                               \
+    SLOWARR_MEMMOVE(DATA(arr) + i, (void*)(T*)vals, n * sizeof(T));            \
+    arr->len += n;                                                             \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, removeRange)(A * arr, SLOWARR_SZT i, SLOWARR_SZT n,  \
+                                       T * out)                                \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(i <= arr->len && n <= arr->len - i);             \
+    if (!n)                                                                    \
+      return;                                                                  \
+    if (out)                                                                   \
+      SLOWARR_MEMMOVE(out, DATA(arr) + i, n * sizeof(T));                      \
+    SLOWARR_MEMMOVE(DATA(arr) + i, DATA(arr) + i + n,                          \
+                    (arr->len - i - n) * sizeof(T));                           \
+    arr->len -= n;                                                             \
+    if (arr->attr & SLOWARR__ZEROIZE)                                          \
+      SLOWARR_MEMZERO(DATA(arr) + arr->len, n * sizeof(T));                    \
+    if (SLOWARR_SHOULD_SHRINK(T, arr->len, arr->cap)) {                        \
+      FN(K, shrinkTo)(arr, SLOWARR_SHRINK_TO(T, arr->len));                    \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void FN(K, resize)(A * arr, SLOWARR_SZT len)                    \
+  {                                                                            \
+    if (len < arr->len) {                                                      \
+      FN(K, removeRange)(arr, len, arr->len - len, (T*)(void*)0);              \
+      return;                                                                  \
+    }                                                                          \
+    SLOWARR_MEMZERO(FN(K, pushUninit)(arr, len - arr->len),                    \
+                    (len - arr->len) * sizeof(T));                             \
+  }
+
+#define SLOWARR__REALLOC_DEFAULT(arr, ptr, old, news) \
+  SLOWARR_REALLOC(ptr, old, news)
+#define SLOWARR__FREE_DEFAULT(arr, ptr, size) SLOWARR_FREE(ptr, size)
+#define SLOWARR__DATA_DEFAULT(arr) ((arr)->data)
+#define SLOWARR__SETDATA_DEFAULT(arr, ptr) ((arr)->data = (ptr))
+#define SLOWARR__INLCAP_DEFAULT(arr) ((SLOWARR_SZT)0)
+
+#define SLOWARR_Header(T)                     \
+  SLOWARR_BEGINC                              \
+  /** usage: T(Arr,int) myarr = {0}; */       \
+  typedef struct                              \
+  {                                           \
+    SLOWARR_SZT cap, len;                     \
+    T* data;                                  \
+    unsigned char attr;                       \
+  } SLOWARR_MANGLE(T);                        \
+  SLOWARR__DECL(T, T, SLOWARR_MANGLE(T), SLOWARR_MANGLE_F) \
+  SLOWARR_ENDC                                \
+                                              \
+  SLOWARR_CXX_HEADER(T)                       \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWARR_Header(T) first */
+#define SLOWARR_Impl(T)                                                  \
+  SLOWARR_BEGINC                                                         \
+  SLOWARR__IMPL(T, T, SLOWARR_MANGLE(T), SLOWARR_MANGLE_F,               \
+                SLOWARR__REALLOC_DEFAULT, SLOWARR__FREE_DEFAULT,         \
+                SLOWARR__DATA_DEFAULT, SLOWARR__SETDATA_DEFAULT,         \
+                SLOWARR__INLCAP_DEFAULT)                                 \
+  SLOWARR_ENDC                                                           \
+  SLOWARR_REQUIRE_SEMI
+
+/* ==== Arrays with an allocator ====
+ *
+ * Same functions as SLOWARR_Header(T), plus make(alloc),
+ * but allocates with `arr.alloc` (see slowarr_allocator), if it is not null.
+ * The allocator has to outlive the array.
+ *
+ * usage: T(SLOWARR__A, int) arr = F(SLOWARR__A, int, make)(&alloc);
+ */
+#define SLOWARR_MANGLE_A(T) SLOWARR_NAMESPACE(A__##T)
+#define SLOWARR_MANGLE_AF(T, F) SLOWARR_NAMESPACE(A__##T##__##F)
+
+#define SLOWARR__REALLOC_A(arr, ptr, old, news)                             \
+  ((arr)->alloc ? (arr)->alloc->realloc((arr)->alloc->ctx, ptr, old, news) \
+                : SLOWARR_REALLOC(ptr, old, news))
+#define SLOWARR__FREE_A(arr, ptr, size)                    \
+  do {                                                     \
+    if ((arr)->alloc)                                      \
+      (arr)->alloc->free((arr)->alloc->ctx, ptr, size);    \
+    else                                                   \
+      SLOWARR_FREE(ptr, size);                             \
+  } while (0)
+
+#define SLOWARR_HeaderA(T)                                                 \
+  SLOWARR_BEGINC                                                           \
+  typedef struct                                                           \
+  {                                                                        \
+    SLOWARR_SZT cap, len;                                                  \
+    T* data;                                                               \
+    unsigned char attr;                                                    \
+    slowarr_allocator const* alloc;                                        \
+  } SLOWARR_MANGLE_A(T);                                                   \
+                                                                           \
+  /** empty array, that will allocate from alloc */                        \
+  SLOWARR_FUNC SLOWARR_MANGLE_A(T)                                         \
+      SLOWARR_MANGLE_AF(T, make)(slowarr_allocator const* alloc);          \
+  SLOWARR__DECL(T, T, SLOWARR_MANGLE_A(T), SLOWARR_MANGLE_AF)              \
+  SLOWARR_ENDC                                                             \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWARR_HeaderA(T) first */
+#define SLOWARR_ImplA(T)                                                   \
+  SLOWARR_BEGINC                                                           \
+  SLOWARR_FUNC SLOWARR_MANGLE_A(T)                                         \
+      SLOWARR_MANGLE_AF(T, make)(slowarr_allocator const* alloc)           \
+  {                                                                        \
+    SLOWARR_MANGLE_A(T) arr;                                               \
+    SLOWARR_MEMZERO(&arr, sizeof(arr));                                    \
+    arr.alloc = alloc;                                                     \
+    return arr;                                                            \
+  }                                                                        \
+  SLOWARR__IMPL(T, T, SLOWARR_MANGLE_A(T), SLOWARR_MANGLE_AF,              \
+                SLOWARR__REALLOC_A, SLOWARR__FREE_A,                       \
+                SLOWARR__DATA_DEFAULT, SLOWARR__SETDATA_DEFAULT,           \
+                SLOWARR__INLCAP_DEFAULT)                                   \
+  SLOWARR_ENDC                                                             \
+  SLOWARR_REQUIRE_SEMI
+
+/* ==== Arrays with inline storage ====
+ *
+ * Same functions as SLOWARR_Header(T), but the first N elements are stored
+ * inside of the struct, and only larger arrays are allocated with
+ * SLOWARR_REALLOC. `arr.data` is null while the elements are inline,
+ * so use ptr(arr) to access them. The struct can be copied and moved
+ * like the other variants (as long as it is not used twice).
+ * Zeroize arrays zeroize the old storage when moving between the two.
+ *
+ * usage: T(SLOWARR__S8, int) arr = {0};
+ *        F(SLOWARR__S8, int, push)(&arr, 1);
+ *        F(SLOWARR__S8, int, ptr)(&arr)[0];
+ */
+#define SLOWARR_MANGLE_S(T, N) SLOWARR_NAMESPACE(S##N##__##T)
+
+/* moves between inl and the heap, depending on the new size */
+static inline void* slowarr__sbo_realloc(void* inl,
+                                         SLOWARR_SZT inl_size,
+                                         int zeroize,
+                                         void* ptr,
+                                         SLOWARR_SZT old,
+                                         SLOWARR_SZT news)
+{
+  void* n;
+  if (news <= inl_size) {
+    if (ptr == inl)
+      return inl;
+    SLOWARR_MEMMOVE(inl, ptr, news);
+    if (zeroize)
+      SLOWARR_MEMZERO(ptr, old);
+    SLOWARR_FREE(ptr, old);
+    return inl;
+  }
+  if (ptr != inl)
+    return SLOWARR_REALLOC(ptr, old, news);
+  n = SLOWARR_REALLOC((void*)0, 0, news);
+  if (n) {
+    SLOWARR_MEMMOVE(n, inl, old);
+    if (zeroize)
+      SLOWARR_MEMZERO(inl, old);
+  }
+  return n;
+}
+
+#define SLOWARR__REALLOC_SBO(arr, ptr, old, news)                        \
+  slowarr__sbo_realloc((arr)->inl, sizeof((arr)->inl),                   \
+                       (arr)->attr & SLOWARR__ZEROIZE, ptr, old, news)
+#define SLOWARR__FREE_SBO(arr, ptr, size)                 \
+  do {                                                    \
+    if ((void*)(ptr) != (void*)(arr)->inl)                \
+      SLOWARR_FREE(ptr, size);                            \
+  } while (0)
+#define SLOWARR__DATA_SBO(arr) ((arr)->data ? (arr)->data : (arr)->inl)
+#define SLOWARR__SETDATA_SBO(arr, ptr) \
+  ((arr)->data = (ptr) == (arr)->inl ? 0 : (ptr))
+#define SLOWARR__INLCAP_SBO(arr) \
+  ((SLOWARR_SZT)(sizeof((arr)->inl) / sizeof((arr)->inl[0])))
+
+#define SLOWARR_HeaderSBO(T, N)                                            \
+  SLOWARR_BEGINC                                                           \
+  typedef struct                                                           \
+  {                                                                        \
+    SLOWARR_SZT cap, len;                                                  \
+    T* data; /* null while inline */                                       \
+    unsigned char attr;                                                    \
+    T inl[N];                                                              \
+  } SLOWARR_MANGLE_S(T, N);                                                \
+                                                                           \
+  SLOWARR__DECL(T, S##N##__##T, SLOWARR_MANGLE_S(T, N), SLOWARR_MANGLE_F)  \
+  SLOWARR_ENDC                                                             \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWARR_HeaderSBO(T, N) first */
+#define SLOWARR_ImplSBO(T, N)                                              \
+  SLOWARR_BEGINC                                                           \
+  SLOWARR__IMPL(T, S##N##__##T, SLOWARR_MANGLE_S(T, N), SLOWARR_MANGLE_F,  \
+                SLOWARR__REALLOC_SBO, SLOWARR__FREE_SBO,                   \
+                SLOWARR__DATA_SBO, SLOWARR__SETDATA_SBO,                   \
+                SLOWARR__INLCAP_SBO)                                       \
+  SLOWARR_ENDC                                                             \
   SLOWARR_REQUIRE_SEMI
 
 #endif
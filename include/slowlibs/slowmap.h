@@ -0,0 +1,318 @@
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/* ======== Hash map ========
+ *
+ * Open addressing with Robin Hood probing: an entry never is further away
+ * from its home slot than the entry it would displace, which keeps probe
+ * sequences short, and lets lookups of missing keys stop early.
+ * Removing shifts the following entries back, so there are no tombstones.
+ *
+ * The (never 0) hash of every slot is kept in a separate array,
+ * so probing only compares hashes, and only calls EQ on a match.
+ * Max load factor is SLOWMAP_LOAD_NUM / SLOWMAP_LOAD_DEN.
+ *
+ * Configured like slowarr.h (SLOWARR_NAMESPACE, SLOWARR_REALLOC, ...),
+ * allocates from `map.alloc` if that is not null (see slowarr_allocator),
+ * and supports SLOWARR__ZEROIZE in `map.attr`.
+ *
+ * HASH(key) returns an unsigned, EQ(a, b) returns non-zero if equal.
+ * Provided: SLOWMAP_HASH_INT / SLOWMAP_EQ for integers and pointers,
+ *           SLOWMAP_HASH_STR / SLOWMAP_EQ_STR for char const* strings.
+ *
+ * usage:
+ *     typedef char const* cstr;
+ *     SLOWMAP_Header(cstr, int);
+ *     SLOWMAP_Impl(cstr, int, SLOWMAP_HASH_STR, SLOWMAP_EQ_STR);  only once
+ *
+ *     T(SLOWARR__M__cstr, int) m = {0};
+ *     F(SLOWARR__M__cstr, int, put)(&m, "a", 1);
+ *     int* v = F(SLOWARR__M__cstr, int, get)(&m, "a");
+ *
+ *     SLOWARR_SZT it = 0;
+ *     T(SLOWARR__ME__cstr, int)* e;
+ *     while ((e = F(SLOWARR__M__cstr, int, next)(&m, &it)))
+ *       use e->key, e->val
+ *
+ *     F(SLOWARR__M__cstr, int, unsafeClear)(&m);
+ */
+
+#ifndef SLOWMAP_H_
+#define SLOWMAP_H_
+
+#include "slowarr.h"
+
+#ifndef SLOWMAP_LOAD_NUM
+#define SLOWMAP_LOAD_NUM 7
+#define SLOWMAP_LOAD_DEN 8
+#endif
+
+#define SLOWMAP_MANGLE(K, V) SLOWARR_NAMESPACE(M__##K##__##V)
+#define SLOWMAP_MANGLE_E(K, V) SLOWARR_NAMESPACE(ME__##K##__##V)
+#define SLOWMAP_MANGLE_F(K, V, F) SLOWARR_NAMESPACE(M__##K##__##V##__##F)
+
+/* finalizer of MurmurHash3 (64 bit) */
+static inline unsigned slowmap_hash_int(unsigned long long x)
+{
+  x ^= x >> 33;
+  x *= 0xff51afd7ed558ccdULL;
+  x ^= x >> 33;
+  x *= 0xc4ceb9fe1a85ec53ULL;
+  x ^= x >> 33;
+  return (unsigned)x;
+}
+
+/* FNV-1a */
+static inline unsigned slowmap_hash_str(char const* s)
+{
+  unsigned long h = 2166136261UL;
+  for (; *s; s++)
+    h = ((h ^ (unsigned char)*s) * 16777619UL) & 0xFFFFFFFFUL;
+  return (unsigned)h;
+}
+
+static inline int slowmap_eq_str(char const* a, char const* b)
+{
+  for (; *a && *a == *b; a++, b++)
+    ;
+  return *a == *b;
+}
+
+#define SLOWMAP_HASH_INT(k) slowmap_hash_int((unsigned long long)(k))
+#define SLOWMAP_EQ(a, b) ((a) == (b))
+#define SLOWMAP_HASH_STR(k) slowmap_hash_str(k)
+#define SLOWMAP_EQ_STR(a, b) slowmap_eq_str(a, b)
+
+/* marks a slot as used */
+#define SLOWMAP__USED (1u << (sizeof(unsigned) * 8 - 1))
+#define SLOWMAP__DIST(m, i) (((i) - (m)->hashes[i]) & ((m)->cap - 1))
+
+#define SLOWMAP_Header(K, V)                                                   \
+  SLOWARR_BEGINC                                                               \
+  typedef struct                                                               \
+  {                                                                            \
+    K key;                                                                     \
+    V val;                                                                     \
+  } SLOWMAP_MANGLE_E(K, V);                                                    \
+                                                                               \
+  typedef struct                                                               \
+  {                                                                            \
+    SLOWARR_SZT cap; /* 0 or a power of two */                                 \
+    SLOWARR_SZT len;                                                           \
+    SLOWMAP_MANGLE_E(K, V) * entries;                                          \
+    unsigned* hashes; /* 0 if empty */                                         \
+    unsigned char attr;                                                        \
+    slowarr_allocator const* alloc;                                            \
+  } SLOWMAP_MANGLE(K, V);                                                      \
+                                                                               \
+  /** empty map, that will allocate from alloc */                              \
+  SLOWARR_FUNC SLOWMAP_MANGLE(K, V)                                            \
+      SLOWMAP_MANGLE_F(K, V, make)(slowarr_allocator const* alloc);            \
+                                                                               \
+  /** frees the table, without destroying the keys and values */               \
+  SLOWARR_FUNC void SLOWMAP_MANGLE_F(K, V, unsafeClear)(SLOWMAP_MANGLE(K, V) * \
+                                                        m);                    \
+                                                                               \
+  /** make room for num entries in total, without rehashing */                 \
+  SLOWARR_FUNC void SLOWMAP_MANGLE_F(K, V, reserve)(SLOWMAP_MANGLE(K, V) * m,  \
+                                                    SLOWARR_SZT num);          \
+                                                                               \
+  /** null if not found */                                                     \
+  SLOWARR_FUNC V* SLOWMAP_MANGLE_F(K, V, get)(SLOWMAP_MANGLE(K, V) * m,        \
+                                              K key);                          \
+                                                                               \
+  /** inserts, or overwrites the value. returns where the value is */          \
+  SLOWARR_FUNC V* SLOWMAP_MANGLE_F(K, V, put)(SLOWMAP_MANGLE(K, V) * m,        \
+                                              K key, V val);                   \
+                                                                               \
+  /** returns 0 if not found. copies the value to out, if it is not null */    \
+  SLOWARR_FUNC int SLOWMAP_MANGLE_F(K, V, remove)(SLOWMAP_MANGLE(K, V) * m,    \
+                                                  K key, V * out);             \
+                                                                               \
+  /** next entry at or after *it, and advances *it. null at the end.           \
+   * start with *it = 0. the map must not be changed while iterating */        \
+  SLOWARR_FUNC SLOWMAP_MANGLE_E(K, V) *                                        \
+      SLOWMAP_MANGLE_F(K, V, next)(SLOWMAP_MANGLE(K, V) * m,                   \
+                                   SLOWARR_SZT * it);                          \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWMAP_Header(K, V) first */
+#define SLOWMAP_Impl(K, V, HASH, EQ)                                           \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC SLOWMAP_MANGLE(K, V)                                            \
+      SLOWMAP_MANGLE_F(K, V, make)(slowarr_allocator const* alloc)             \
+  {                                                                            \
+    SLOWMAP_MANGLE(K, V) m;                                                    \
+    SLOWARR_MEMZERO(&m, sizeof(m));                                            \
+    m.alloc = alloc;                                                           \
+    return m;                                                                  \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWMAP_MANGLE_F(K, V, unsafeClear)(SLOWMAP_MANGLE(K, V) * \
+                                                        m)                     \
+  {                                                                            \
+    SLOWARR_SZT size = m->cap * (sizeof(*m->entries) + sizeof(unsigned));      \
+    if (m->entries) {                                                          \
+      if (m->attr & SLOWARR__ZEROIZE)                                          \
+        SLOWARR_MEMZERO(m->entries, size);                                     \
+      SLOWARR__FREE_A(m, m->entries, size);                                    \
+    }                                                                          \
+    m->entries = (SLOWMAP_MANGLE_E(K, V)*)(void*)0;                            \
+    m->hashes = (unsigned*)(void*)0;                                           \
+    m->cap = 0;                                                                \
+    m->len = 0;                                                                \
+    /* don't change attrs */                                                   \
+  }                                                                            \
+                                                                               \
+  /* inserts an entry that is not in the map yet, and the table has space */   \
+  static SLOWARR_SZT SLOWMAP_MANGLE_F(K, V, _insert)(SLOWMAP_MANGLE(K, V) * m, \
+                                                     unsigned h,               \
+                                                     SLOWMAP_MANGLE_E(K, V) e) \
+  {                                                                            \
+    SLOWARR_SZT mask = m->cap - 1, i = h & mask, dist = 0, d, at = m->cap;     \
+    SLOWMAP_MANGLE_E(K, V) te;                                                 \
+    unsigned th;                                                               \
+    for (;; i = (i + 1) & mask, dist++) {                                      \
+      if (!m->hashes[i]) {                                                     \
+        m->hashes[i] = h;                                                      \
+        m->entries[i] = e;                                                     \
+        return at == m->cap ? i : at;                                          \
+      }                                                                        \
+      d = SLOWMAP__DIST(m, i);                                                 \
+      /* take from the rich: the new entry takes this slot */                  \
+      if (d < dist) {                                                          \
+        th = m->hashes[i];                                                     \
+        te = m->entries[i];                                                    \
+        m->hashes[i] = h;                                                      \
+        m->entries[i] = e;                                                     \
+        h = th;                                                                \
+        e = te;                                                                \
+        dist = d;                                                              \
+        if (at == m->cap)                                                      \
+          at = i;                                                              \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWMAP_MANGLE_F(K, V, reserve)(SLOWMAP_MANGLE(K, V) * m,  \
+                                                    SLOWARR_SZT num)           \
+  {                                                                            \
+    SLOWMAP_MANGLE(K, V) n = *m;                                               \
+    SLOWARR_SZT cap = m->cap ? m->cap : 8, i, size;                            \
+    if (num * SLOWMAP_LOAD_DEN <= m->cap * SLOWMAP_LOAD_NUM)                   \
+      return;                                                                  \
+    while (num * SLOWMAP_LOAD_DEN > cap * SLOWMAP_LOAD_NUM)                    \
+      cap <<= 1;                                                               \
+                                                                               \
+    size = cap * (sizeof(*m->entries) + sizeof(unsigned));                     \
+    n.entries = (SLOWMAP_MANGLE_E(K, V)*)SLOWARR__REALLOC_A(m, (void*)0, 0,    \
+                                                            size);             \
+    if (!n.entries)                                                            \
+      SLOWARR_ON_MALLOC_FAIL(size);                                            \
+    /* entries first, to keep them aligned */                                  \
+    n.hashes = (unsigned*)(void*)(n.entries + cap);                            \
+    SLOWARR_MEMZERO(n.hashes, cap * sizeof(unsigned));                         \
+    n.cap = cap;                                                               \
+                                                                               \
+    for (i = 0; i < m->cap; i++)                                               \
+      if (m->hashes[i])                                                        \
+        SLOWMAP_MANGLE_F(K, V, _insert)(&n, m->hashes[i], m->entries[i]);      \
+    SLOWMAP_MANGLE_F(K, V, unsafeClear)(m);                                    \
+    *m = n;                                                                    \
+  }                                                                            \
+                                                                               \
+  /* slot of key, or cap if not found */                                       \
+  static SLOWARR_SZT SLOWMAP_MANGLE_F(K, V, _find)(SLOWMAP_MANGLE(K, V) * m,   \
+                                                   K key)                      \
+  {                                                                            \
+    unsigned h, hi;                                                            \
+    SLOWARR_SZT mask, i, dist;                                                 \
+    if (!m->len)                                                               \
+      return m->cap;                                                           \
+    h = (unsigned)(HASH(key)) | SLOWMAP__USED;                                 \
+    mask = m->cap - 1;                                                         \
+    for (i = h & mask, dist = 0;; i = (i + 1) & mask, dist++) {                \
+      hi = m->hashes[i];                                                       \
+      /* it would have displaced this one */                                   \
+      if (!hi || SLOWMAP__DIST(m, i) < dist)                                   \
+        return m->cap;                                                         \
+      if (hi == h && EQ(m->entries[i].key, key))                               \
+        return i;                                                              \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC V* SLOWMAP_MANGLE_F(K, V, get)(SLOWMAP_MANGLE(K, V) * m, K key) \
+  {                                                                            \
+    SLOWARR_SZT i = SLOWMAP_MANGLE_F(K, V, _find)(m, key);                     \
+    return i == m->cap ? (V*)(void*)0 : &m->entries[i].val;                    \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC V* SLOWMAP_MANGLE_F(K, V, put)(SLOWMAP_MANGLE(K, V) * m,        \
+                                              K key, V val)                    \
+  {                                                                            \
+    SLOWMAP_MANGLE_E(K, V) e;                                                  \
+    V* old = SLOWMAP_MANGLE_F(K, V, get)(m, key);                              \
+    if (old) {                                                                 \
+      *old = val;                                                              \
+      return old;                                                              \
+    }                                                                          \
+    SLOWMAP_MANGLE_F(K, V, reserve)(m, m->len + 1);                            \
+    e.key = key;                                                               \
+    e.val = val;                                                               \
+    m->len++;                                                                  \
+    return &m->entries[SLOWMAP_MANGLE_F(K, V, _insert)(                        \
+                           m, (unsigned)(HASH(key)) | SLOWMAP__USED, e)]       \
+                .val;                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC int SLOWMAP_MANGLE_F(K, V, remove)(SLOWMAP_MANGLE(K, V) * m,    \
+                                                  K key, V * out)              \
+  {                                                                            \
+    SLOWARR_SZT i = SLOWMAP_MANGLE_F(K, V, _find)(m, key), next;               \
+    SLOWARR_SZT mask = m->cap - 1;                                             \
+    if (i == m->cap)                                                           \
+      return 0;                                                                \
+    if (out)                                                                   \
+      *out = m->entries[i].val;                                                \
+    /* backward shift: move the following entries one slot closer to home */   \
+    for (next = (i + 1) & mask;                                                \
+         m->hashes[next] && SLOWMAP__DIST(m, next) != 0;                       \
+         i = next, next = (next + 1) & mask) {                                 \
+      m->hashes[i] = m->hashes[next];                                          \
+      m->entries[i] = m->entries[next];                                        \
+    }                                                                          \
+    m->hashes[i] = 0;                                                          \
+    if (m->attr & SLOWARR__ZEROIZE)                                            \
+      SLOWARR_MEMZERO(&m->entries[i], sizeof(m->entries[i]));                  \
+    m->len--;                                                                  \
+    return 1;                                                                  \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC SLOWMAP_MANGLE_E(K, V) *                                        \
+      SLOWMAP_MANGLE_F(K, V, next)(SLOWMAP_MANGLE(K, V) * m, SLOWARR_SZT * it) \
+  {                                                                            \
+    for (; *it < m->cap; (*it)++)                                              \
+      if (m->hashes[*it])                                                      \
+        return &m->entries[(*it)++];                                           \
+    return (SLOWMAP_MANGLE_E(K, V)*)(void*)0;                                  \
+  }                                                                            \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+#endif
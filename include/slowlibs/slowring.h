@@ -0,0 +1,326 @@
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/* ======== Ring buffer / deque ========
+ *
+ * Power-of-two capacity, element i is at data[(head + i) & (cap - 1)].
+ * Push and pop at both ends are amortized O(1).
+ *
+ * Configured like slowarr.h (SLOWARR_NAMESPACE, SLOWARR_REALLOC, ...),
+ * allocates from `ring.alloc` if that is not null (see slowarr_allocator),
+ * and supports SLOWARR__ZEROIZE in `ring.attr`.
+ *
+ * usage:
+ *     SLOWRING_Header(int);
+ *     SLOWRING_Impl(int);    only once in your program
+ *
+ *     T(SLOWARR__R, int) q = {0};
+ *     F(SLOWARR__R, int, pushBack)(&q, 1);
+ *     F(SLOWARR__R, int, popFront)(&q);
+ *     F(SLOWARR__R, int, unsafeClear)(&q);
+ *
+ * zero-copy I/O:
+ *     F(SLOWARR__R, int, reserve)(&q, 4096);
+ *     p = F(SLOWARR__R, int, writeSpan)(&q, &n);
+ *     n = read(fd, p, n);
+ *     F(SLOWARR__R, int, commit)(&q, n);
+ *
+ *     p = F(SLOWARR__R, int, readSpan)(&q, &n);
+ *     n = write(fd, p, n);
+ *     F(SLOWARR__R, int, consume)(&q, n);
+ */
+
+#ifndef SLOWRING_H_
+#define SLOWRING_H_
+
+#include "slowarr.h"
+
+#define SLOWRING_MANGLE(T) SLOWARR_NAMESPACE(R__##T)
+#define SLOWRING_MANGLE_F(T, F) SLOWARR_NAMESPACE(R__##T##__##F)
+
+#define SLOWRING__MASK(r) ((r)->cap - 1)
+
+#define SLOWRING_Header(T)                                                     \
+  SLOWARR_BEGINC                                                               \
+  typedef struct                                                               \
+  {                                                                            \
+    SLOWARR_SZT cap; /* 0 or a power of two */                                 \
+    SLOWARR_SZT head, len;                                                     \
+    T* data;                                                                   \
+    unsigned char attr;                                                        \
+    slowarr_allocator const* alloc;                                            \
+  } SLOWRING_MANGLE(T);                                                        \
+                                                                               \
+  /** empty ring, that will allocate from alloc */                             \
+  SLOWARR_FUNC SLOWRING_MANGLE(T)                                              \
+      SLOWRING_MANGLE_F(T, make)(slowarr_allocator const* alloc);              \
+                                                                               \
+  /** frees the buffer, without destroying the elements */                     \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, unsafeClear)(SLOWRING_MANGLE(T) * r); \
+                                                                               \
+  /** cap becomes the next power of two >= num */                              \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, reserveTotal)(SLOWRING_MANGLE(T) * r, \
+                                                       SLOWARR_SZT num);       \
+                                                                               \
+  /** make room for n more elements */                                         \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, reserve)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT n);              \
+                                                                               \
+  /** element i, counted from the front. fails if oob */                       \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, at)(SLOWRING_MANGLE(T) * r,             \
+                                           SLOWARR_SZT i);                     \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, pushBackRef)(SLOWRING_MANGLE(T) * r);   \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, pushFrontRef)(SLOWRING_MANGLE(T) * r);  \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushBack)(SLOWRING_MANGLE(T) * r,     \
+                                                   T val);                     \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushFront)(SLOWRING_MANGLE(T) * r,    \
+                                                    T val);                    \
+                                                                               \
+  /** fails if empty */                                                        \
+  SLOWARR_FUNC T SLOWRING_MANGLE_F(T, popFront)(SLOWRING_MANGLE(T) * r);       \
+  SLOWARR_FUNC T SLOWRING_MANGLE_F(T, popBack)(SLOWRING_MANGLE(T) * r);        \
+                                                                               \
+  /** appends n elements, with at most two copies */                           \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushBackN)(SLOWRING_MANGLE(T) * r,    \
+                                                    T const* vals,             \
+                                                    SLOWARR_SZT n);            \
+                                                                               \
+  /** removes n elements from the front, and copies them to out,               \
+   * if it is not null. fails if oob */                                        \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, popFrontN)(SLOWRING_MANGLE(T) * r,    \
+                                                    T * out,                   \
+                                                    SLOWARR_SZT n);            \
+                                                                               \
+  /** the first *n elements, which are contiguous in memory */                 \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, readSpan)(SLOWRING_MANGLE(T) * r,       \
+                                                 SLOWARR_SZT * n);             \
+                                                                               \
+  /** removes n elements from the front. fails if oob */                       \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, consume)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT n);              \
+                                                                               \
+  /** contiguous free space of *n elements after the back. can be 0 */         \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, writeSpan)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT * n);            \
+                                                                               \
+  /** appends the first n elements of the last writeSpan() */                  \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, commit)(SLOWRING_MANGLE(T) * r,       \
+                                                 SLOWARR_SZT n);               \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWRING_Header(T) first */
+#define SLOWRING_Impl(T)                                                       \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC SLOWRING_MANGLE(T)                                              \
+      SLOWRING_MANGLE_F(T, make)(slowarr_allocator const* alloc)               \
+  {                                                                            \
+    SLOWRING_MANGLE(T) r;                                                      \
+    SLOWARR_MEMZERO(&r, sizeof(r));                                            \
+    r.alloc = alloc;                                                           \
+    return r;                                                                  \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, unsafeClear)(SLOWRING_MANGLE(T) * r)  \
+  {                                                                            \
+    if (r->data) {                                                             \
+      if (r->attr & SLOWARR__ZEROIZE)                                          \
+        SLOWARR_MEMZERO(r->data, r->cap * sizeof(T));                          \
+      SLOWARR__FREE_A(r, r->data, r->cap * sizeof(T));                         \
+    }                                                                          \
+    r->data = (T*)(void*)0;                                                    \
+    r->cap = 0;                                                                \
+    r->head = 0;                                                               \
+    r->len = 0;                                                                \
+    /* don't change attrs */                                                   \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, reserveTotal)(SLOWRING_MANGLE(T) * r, \
+                                                       SLOWARR_SZT num)        \
+  {                                                                            \
+    SLOWARR_SZT old = r->cap, cap = r->cap ? r->cap : 1, wrapped;              \
+    void* n;                                                                   \
+    if (num <= r->cap)                                                         \
+      return;                                                                  \
+    while (cap < num)                                                          \
+      cap <<= 1;                                                               \
+    n = SLOWARR__REALLOC_A(r, r->data, old * sizeof(T), cap * sizeof(T));      \
+    if (!n) {                                                                  \
+      if (r->attr & SLOWARR__ZEROIZE)                                          \
+        SLOWARR_MEMZERO(r->data, old * sizeof(T));                             \
+      SLOWARR__FREE_A(r, r->data, old * sizeof(T));                            \
+      SLOWARR_ON_MALLOC_FAIL(cap * sizeof(T));                                 \
+    }                                                                          \
+    r->data = (T*)n;                                                           \
+    /* cap is at least twice old, so the elements that wrapped around          \
+     * fit directly after the old end */                                       \
+    if (r->head + r->len > old) {                                              \
+      wrapped = r->head + r->len - old;                                        \
+      SLOWARR_MEMMOVE(r->data + old, r->data, wrapped * sizeof(T));            \
+      if (r->attr & SLOWARR__ZEROIZE)                                          \
+        SLOWARR_MEMZERO(r->data, wrapped * sizeof(T));                         \
+    }                                                                          \
+    r->cap = cap;                                                              \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, reserve)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT n)               \
+  {                                                                            \
+    if (r->len + n <= r->cap)                                                  \
+      return;                                                                  \
+    if (r->len + n < SLOWARR_CAP_FOR_FIRST_ELEM(T))                            \
+      n = SLOWARR_CAP_FOR_FIRST_ELEM(T) - r->len;                              \
+    SLOWRING_MANGLE_F(T, reserveTotal)(r, r->len + n);                         \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, at)(SLOWRING_MANGLE(T) * r,             \
+                                           SLOWARR_SZT i)                      \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(i < r->len);                                     \
+    return &r->data[(r->head + i) & SLOWRING__MASK(r)];                        \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, pushBackRef)(SLOWRING_MANGLE(T) * r)    \
+  {                                                                            \
+    SLOWRING_MANGLE_F(T, reserve)(r, 1);                                       \
+    return &r->data[(r->head + r->len++) & SLOWRING__MASK(r)];                 \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, pushFrontRef)(SLOWRING_MANGLE(T) * r)   \
+  {                                                                            \
+    SLOWRING_MANGLE_F(T, reserve)(r, 1);                                       \
+    r->head = (r->head - 1) & SLOWRING__MASK(r);                               \
+    r->len++;                                                                  \
+    return &r->data[r->head];                                                  \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushBack)(SLOWRING_MANGLE(T) * r,     \
+                                                   T val)                      \
+  {                                                                            \
+    *SLOWRING_MANGLE_F(T, pushBackRef)(r) = val;                               \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushFront)(SLOWRING_MANGLE(T) * r,    \
+                                                    T val)                     \
+  {                                                                            \
+    *SLOWRING_MANGLE_F(T, pushFrontRef)(r) = val;                              \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T SLOWRING_MANGLE_F(T, popFront)(SLOWRING_MANGLE(T) * r)        \
+  {                                                                            \
+    T temp;                                                                    \
+    SLOWRING_MANGLE_F(T, popFrontN)(r, &temp, 1);                              \
+    return temp;                                                               \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T SLOWRING_MANGLE_F(T, popBack)(SLOWRING_MANGLE(T) * r)         \
+  {                                                                            \
+    T temp;                                                                    \
+    T* slot;                                                                   \
+    SLOWARR_ASSERT_USER_ERROR(r->len > 0);                                     \
+    slot = &r->data[(r->head + r->len - 1) & SLOWRING__MASK(r)];               \
+    temp = *slot;                                                              \
+    if (r->attr & SLOWARR__ZEROIZE)                                            \
+      SLOWARR_MEMZERO(slot, sizeof(T));                                        \
+    if (!--r->len)                                                             \
+      r->head = 0;                                                             \
+    return temp;                                                               \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, pushBackN)(SLOWRING_MANGLE(T) * r,    \
+                                                    T const* vals,             \
+                                                    SLOWARR_SZT n)             \
+  {                                                                            \
+    SLOWARR_SZT tail, first;                                                   \
+    if (!n)                                                                    \
+      return;                                                                  \
+    SLOWRING_MANGLE_F(T, reserve)(r, n);                                       \
+    tail = (r->head + r->len) & SLOWRING__MASK(r);                             \
+    first = r->cap - tail < n ? r->cap - tail : n;                             \
+    SLOWARR_MEMMOVE(r->data + tail, (void*)(T*)vals, first * sizeof(T));       \
+    SLOWARR_MEMMOVE(r->data, (void*)(T*)(vals + first),                        \
+                    (n - first) * sizeof(T));                                  \
+    r->len += n;                                                               \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, popFrontN)(SLOWRING_MANGLE(T) * r,    \
+                                                    T * out,                   \
+                                                    SLOWARR_SZT n)             \
+  {                                                                            \
+    SLOWARR_SZT first;                                                         \
+    SLOWARR_ASSERT_USER_ERROR(n <= r->len);                                    \
+    if (!n)                                                                    \
+      return;                                                                  \
+    if (out) {                                                                 \
+      first = r->cap - r->head < n ? r->cap - r->head : n;                     \
+      SLOWARR_MEMMOVE(out, r->data + r->head, first * sizeof(T));              \
+      SLOWARR_MEMMOVE(out + first, r->data, (n - first) * sizeof(T));          \
+    }                                                                          \
+    SLOWRING_MANGLE_F(T, consume)(r, n);                                       \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, readSpan)(SLOWRING_MANGLE(T) * r,       \
+                                                 SLOWARR_SZT * n)              \
+  {                                                                            \
+    *n = r->cap - r->head < r->len ? r->cap - r->head : r->len;                \
+    return r->data + r->head;                                                  \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, consume)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT n)               \
+  {                                                                            \
+    SLOWARR_SZT first;                                                         \
+    SLOWARR_ASSERT_USER_ERROR(n <= r->len);                                    \
+    if (!n)                                                                    \
+      return;                                                                  \
+    if (r->attr & SLOWARR__ZEROIZE) {                                          \
+      first = r->cap - r->head < n ? r->cap - r->head : n;                     \
+      SLOWARR_MEMZERO(r->data + r->head, first * sizeof(T));                   \
+      SLOWARR_MEMZERO(r->data, (n - first) * sizeof(T));                       \
+    }                                                                          \
+    r->head = (r->head + n) & SLOWRING__MASK(r);                               \
+    r->len -= n;                                                               \
+    /* maximizes the next writeSpan() */                                       \
+    if (!r->len)                                                               \
+      r->head = 0;                                                             \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWRING_MANGLE_F(T, writeSpan)(SLOWRING_MANGLE(T) * r,      \
+                                                  SLOWARR_SZT * n)             \
+  {                                                                            \
+    SLOWARR_SZT tail;                                                          \
+    if (r->len == r->cap) {                                                    \
+      *n = 0;                                                                  \
+      return r->data;                                                          \
+    }                                                                          \
+    tail = (r->head + r->len) & SLOWRING__MASK(r);                             \
+    *n = tail >= r->head ? r->cap - tail : r->head - tail;                     \
+    return r->data + tail;                                                     \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWRING_MANGLE_F(T, commit)(SLOWRING_MANGLE(T) * r,       \
+                                                 SLOWARR_SZT n)                \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(n <= r->cap - r->len);                           \
+    r->len += n;                                                               \
+  }                                                                            \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+#endif
@@ -0,0 +1,247 @@
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/* ======== Segmented array ========
+ *
+ * Elements are stored in fixed-size chunks of 1 << SLOWSEG_CHUNK_SHIFT(T)
+ * elements, element i is at chunks[i >> shift][i & mask].
+ * Growing only allocates new chunks and grows the directory of chunk
+ * pointers, so elements never move: pointers to them stay valid until
+ * they are popped. Unused space is at most one chunk, plus the chunks
+ * kept by reserve() and pop() until shrink().
+ *
+ * Configured like slowarr.h (SLOWARR_NAMESPACE, SLOWARR_REALLOC, ...),
+ * allocates from `seg.alloc` if that is not null (see slowarr_allocator),
+ * and supports SLOWARR__ZEROIZE in `seg.attr`.
+ *
+ * usage:
+ *     SLOWSEG_Header(node);
+ *     SLOWSEG_Impl(node);    only once in your program
+ *
+ *     T(SLOWARR__SG, node) nodes = {0};
+ *     node* n = F(SLOWARR__SG, node, pushRef)(&nodes);
+ *     F(SLOWARR__SG, node, at)(&nodes, 5)->next = n;
+ *     F(SLOWARR__SG, node, unsafeClear)(&nodes);
+ *
+ * iterating chunk by chunk:
+ *     for (i = 0; i < nodes.len; i += n) {
+ *       p = F(SLOWARR__SG, node, span)(&nodes, i, &n);
+ *       ... p[0] to p[n - 1] ...
+ *     }
+ */
+
+#ifndef SLOWSEG_H_
+#define SLOWSEG_H_
+
+#include "slowarr.h"
+
+#ifndef SLOWSEG_CHUNK_SHIFT
+/* chunks have 1 << SLOWSEG_CHUNK_SHIFT(T) elements */
+#define SLOWSEG_CHUNK_SHIFT(T) (12)
+#endif
+
+#define SLOWSEG_MANGLE(T) SLOWARR_NAMESPACE(SG__##T)
+#define SLOWSEG_MANGLE_F(T, F) SLOWARR_NAMESPACE(SG__##T##__##F)
+
+#define SLOWSEG__CHUNK(T) ((SLOWARR_SZT)1 << SLOWSEG_CHUNK_SHIFT(T))
+#define SLOWSEG__MASK(T) (SLOWSEG__CHUNK(T) - 1)
+
+#define SLOWSEG_Header(T)                                                      \
+  SLOWARR_BEGINC                                                               \
+  typedef struct                                                               \
+  {                                                                            \
+    T** chunks;                                                                \
+    SLOWARR_SZT nchunks; /* allocated chunks */                                \
+    SLOWARR_SZT dirCap;  /* capacity of chunks */                              \
+    SLOWARR_SZT len;                                                           \
+    unsigned char attr;                                                        \
+    slowarr_allocator const* alloc;                                            \
+  } SLOWSEG_MANGLE(T);                                                         \
+                                                                               \
+  /** empty array, that will allocate from alloc */                            \
+  SLOWARR_FUNC SLOWSEG_MANGLE(T)                                               \
+      SLOWSEG_MANGLE_F(T, make)(slowarr_allocator const* alloc);               \
+                                                                               \
+  /** frees all chunks, without destroying the elements */                     \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, unsafeClear)(SLOWSEG_MANGLE(T) * s);   \
+                                                                               \
+  /** allocates chunks for n more elements */                                  \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, reserve)(SLOWSEG_MANGLE(T) * s,        \
+                                                 SLOWARR_SZT n);               \
+                                                                               \
+  /** frees the chunks that are not needed for the current elements */         \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, shrink)(SLOWSEG_MANGLE(T) * s);        \
+                                                                               \
+  /** element i. fails if oob */                                               \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, at)(SLOWSEG_MANGLE(T) * s,               \
+                                          SLOWARR_SZT i);                      \
+                                                                               \
+  /** element i and the *n elements after it, that are in the same chunk.      \
+   * fails if oob */                                                           \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, span)(SLOWSEG_MANGLE(T) * s,             \
+                                            SLOWARR_SZT i,                     \
+                                            SLOWARR_SZT * n);                  \
+                                                                               \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, pushRef)(SLOWSEG_MANGLE(T) * s);         \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, push)(SLOWSEG_MANGLE(T) * s, T val);   \
+                                                                               \
+  /** appends n elements, with one copy per chunk */                           \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, pushN)(SLOWSEG_MANGLE(T) * s,          \
+                                               T const* vals,                  \
+                                               SLOWARR_SZT n);                 \
+                                                                               \
+  /** fails if empty. keeps the chunk */                                       \
+  SLOWARR_FUNC T SLOWSEG_MANGLE_F(T, pop)(SLOWSEG_MANGLE(T) * s);              \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWSEG_Header(T) first */
+#define SLOWSEG_Impl(T)                                                        \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC SLOWSEG_MANGLE(T)                                               \
+      SLOWSEG_MANGLE_F(T, make)(slowarr_allocator const* alloc)                \
+  {                                                                            \
+    SLOWSEG_MANGLE(T) s;                                                       \
+    SLOWARR_MEMZERO(&s, sizeof(s));                                            \
+    s.alloc = alloc;                                                           \
+    return s;                                                                  \
+  }                                                                            \
+                                                                               \
+  static void SLOWSEG_MANGLE_F(T, _freeChunks)(SLOWSEG_MANGLE(T) * s,          \
+                                               SLOWARR_SZT keep)               \
+  {                                                                            \
+    SLOWARR_SZT bytes = SLOWSEG__CHUNK(T) * sizeof(T);                         \
+    while (s->nchunks > keep) {                                                \
+      s->nchunks--;                                                            \
+      if (s->attr & SLOWARR__ZEROIZE)                                          \
+        SLOWARR_MEMZERO(s->chunks[s->nchunks], bytes);                         \
+      SLOWARR__FREE_A(s, s->chunks[s->nchunks], bytes);                        \
+    }                                                                          \
+    if (!s->nchunks && s->chunks) {                                            \
+      SLOWARR__FREE_A(s, s->chunks, s->dirCap * sizeof(T*));                   \
+      s->chunks = (T**)(void*)0;                                               \
+      s->dirCap = 0;                                                           \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, unsafeClear)(SLOWSEG_MANGLE(T) * s)    \
+  {                                                                            \
+    SLOWSEG_MANGLE_F(T, _freeChunks)(s, 0);                                    \
+    s->len = 0;                                                                \
+    /* don't change attrs */                                                   \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, reserve)(SLOWSEG_MANGLE(T) * s,        \
+                                                 SLOWARR_SZT n)                \
+  {                                                                            \
+    SLOWARR_SZT need =                                                         \
+        (s->len + n + SLOWSEG__MASK(T)) >> SLOWSEG_CHUNK_SHIFT(T);             \
+    SLOWARR_SZT cap = s->dirCap ? s->dirCap : 4;                               \
+    void* p;                                                                   \
+    if (need <= s->nchunks)                                                    \
+      return;                                                                  \
+    /* only the directory is reallocated, never the chunks */                  \
+    if (need > s->dirCap) {                                                    \
+      while (cap < need)                                                       \
+        cap <<= 1;                                                             \
+      p = SLOWARR__REALLOC_A(s, s->chunks, s->dirCap * sizeof(T*),             \
+                             cap * sizeof(T*));                                \
+      if (!p)                                                                  \
+        SLOWARR_ON_MALLOC_FAIL(cap * sizeof(T*));                              \
+      s->chunks = (T**)p;                                                      \
+      s->dirCap = cap;                                                         \
+    }                                                                          \
+    while (s->nchunks < need) {                                                \
+      p = SLOWARR__REALLOC_A(s, (void*)0, 0, SLOWSEG__CHUNK(T) * sizeof(T));   \
+      if (!p)                                                                  \
+        SLOWARR_ON_MALLOC_FAIL(SLOWSEG__CHUNK(T) * sizeof(T));                 \
+      s->chunks[s->nchunks++] = (T*)p;                                         \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, shrink)(SLOWSEG_MANGLE(T) * s)         \
+  {                                                                            \
+    SLOWSEG_MANGLE_F(T, _freeChunks)(                                          \
+        s, (s->len + SLOWSEG__MASK(T)) >> SLOWSEG_CHUNK_SHIFT(T));             \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, at)(SLOWSEG_MANGLE(T) * s,               \
+                                          SLOWARR_SZT i)                       \
+  {                                                                            \
+    SLOWARR_ASSERT_USER_ERROR(i < s->len);                                     \
+    return &s->chunks[i >> SLOWSEG_CHUNK_SHIFT(T)][i & SLOWSEG__MASK(T)];      \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, span)(SLOWSEG_MANGLE(T) * s,             \
+                                            SLOWARR_SZT i,                     \
+                                            SLOWARR_SZT * n)                   \
+  {                                                                            \
+    SLOWARR_SZT room = SLOWSEG__CHUNK(T) - (i & SLOWSEG__MASK(T));             \
+    SLOWARR_ASSERT_USER_ERROR(i < s->len);                                     \
+    *n = s->len - i < room ? s->len - i : room;                                \
+    return &s->chunks[i >> SLOWSEG_CHUNK_SHIFT(T)][i & SLOWSEG__MASK(T)];      \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T* SLOWSEG_MANGLE_F(T, pushRef)(SLOWSEG_MANGLE(T) * s)          \
+  {                                                                            \
+    SLOWARR_SZT i = s->len;                                                    \
+    SLOWSEG_MANGLE_F(T, reserve)(s, 1);                                        \
+    s->len++;                                                                  \
+    return &s->chunks[i >> SLOWSEG_CHUNK_SHIFT(T)][i & SLOWSEG__MASK(T)];      \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, push)(SLOWSEG_MANGLE(T) * s, T val)    \
+  {                                                                            \
+    *SLOWSEG_MANGLE_F(T, pushRef)(s) = val;                                    \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSEG_MANGLE_F(T, pushN)(SLOWSEG_MANGLE(T) * s,          \
+                                               T const* vals,                  \
+                                               SLOWARR_SZT n)                  \
+  {                                                                            \
+    SLOWARR_SZT room, k;                                                       \
+    SLOWSEG_MANGLE_F(T, reserve)(s, n);                                        \
+    while (n) {                                                                \
+      room = SLOWSEG__CHUNK(T) - (s->len & SLOWSEG__MASK(T));                  \
+      k = n < room ? n : room;                                                 \
+      SLOWARR_MEMMOVE(&s->chunks[s->len >> SLOWSEG_CHUNK_SHIFT(T)]             \
+                                [s->len & SLOWSEG__MASK(T)],                   \
+                      (void*)(T*)vals, k * sizeof(T));                         \
+      s->len += k;                                                             \
+      vals += k;                                                               \
+      n -= k;                                                                  \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC T SLOWSEG_MANGLE_F(T, pop)(SLOWSEG_MANGLE(T) * s)               \
+  {                                                                            \
+    T temp;                                                                    \
+    T* slot;                                                                   \
+    SLOWARR_ASSERT_USER_ERROR(s->len > 0);                                     \
+    s->len--;                                                                  \
+    slot = &s->chunks[s->len >> SLOWSEG_CHUNK_SHIFT(T)]                        \
+                     [s->len & SLOWSEG__MASK(T)];                              \
+    temp = *slot;                                                              \
+    if (s->attr & SLOWARR__ZEROIZE)                                            \
+      SLOWARR_MEMZERO(slot, sizeof(T));                                        \
+    return temp;                                                               \
+  }                                                                            \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+#endif
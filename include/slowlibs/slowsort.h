@@ -0,0 +1,240 @@
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+/* ======== Sorting and searching ========
+ *
+ * Type-specialized, so the comparison is inlined instead of being an
+ * indirect call like with qsort().
+ * Configured like slowarr.h (SLOWARR_NAMESPACE, SLOWARR_MEMMOVE, ...).
+ * Works on plain arrays: pass arr.data and arr.len for slowarr arrays.
+ *
+ * SLOWSORT_Header(NAME, T) / SLOWSORT_Impl(NAME, T, LESS):
+ *   LESS(a, b) is non-zero if a goes before b.
+ *   - sort(data, n): introsort (quicksort, heapsort if quicksort degrades,
+ *     insertion sort for small ranges). not stable. O(n log n)
+ *   - lowerBound(data, n, key): index of the first element that is
+ *     not LESS than key, or n. data has to be sorted. branchless.
+ *
+ * SLOWSORT_RadixHeader(NAME, T) / SLOWSORT_RadixImpl(NAME, T, KEY, BYTES):
+ *   KEY(x) returns an unsigned integer of BYTES bytes, which is sorted
+ *   ascending. Use SLOWSORT_KEY_I32 / SLOWSORT_KEY_I64 for signed keys.
+ *   - radixSort(data, scratch, n): LSD radix sort. stable. O(n * BYTES)
+ *     scratch has to have space for n elements.
+ *
+ * usage:
+ *     #define BY_X(a, b) ((a).x < (b).x)
+ *     SLOWSORT_Header(point_x, point);
+ *     SLOWSORT_Impl(point_x, point, BY_X);   only once in your program
+ *
+ *     F(SLOWARR__SO, point_x, sort)(arr.data, arr.len);
+ *     i = F(SLOWARR__SO, point_x, lowerBound)(arr.data, arr.len, key);
+ */
+
+#ifndef SLOWSORT_H_
+#define SLOWSORT_H_
+
+#include "slowarr.h"
+
+#ifndef SLOWSORT_INSERTION_MAX
+/* ranges up to this size are insertion sorted */
+#define SLOWSORT_INSERTION_MAX 16
+#endif
+
+#define SLOWSORT_MANGLE_F(NAME, F) SLOWARR_NAMESPACE(SO__##NAME##__##F)
+
+#define SLOWSORT_KEY_I32(x) ((unsigned long)(x) ^ 0x80000000UL)
+#define SLOWSORT_KEY_I64(x) \
+  ((unsigned long long)(x) ^ 0x8000000000000000ULL)
+
+#define SLOWSORT_Header(NAME, T)                                               \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC void SLOWSORT_MANGLE_F(NAME, sort)(T * data, SLOWARR_SZT n);    \
+                                                                               \
+  SLOWARR_FUNC SLOWARR_SZT SLOWSORT_MANGLE_F(NAME, lowerBound)(T const* data,  \
+                                                               SLOWARR_SZT n,  \
+                                                               T key);         \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWSORT_Header first */
+#define SLOWSORT_Impl(NAME, T, LESS)                                           \
+  SLOWARR_BEGINC                                                               \
+  static void SLOWSORT_MANGLE_F(NAME, _insertion)(T * data, SLOWARR_SZT n)     \
+  {                                                                            \
+    SLOWARR_SZT i, j;                                                          \
+    T x;                                                                       \
+    for (i = 1; i < n; i++) {                                                  \
+      x = data[i];                                                             \
+      for (j = i; j > 0 && LESS(x, data[j - 1]); j--)                          \
+        data[j] = data[j - 1];                                                 \
+      data[j] = x;                                                             \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  static void SLOWSORT_MANGLE_F(NAME, _sift)(T * data, SLOWARR_SZT i,          \
+                                             SLOWARR_SZT n)                    \
+  {                                                                            \
+    SLOWARR_SZT c;                                                             \
+    T x = data[i];                                                             \
+    for (; (c = 2 * i + 1) < n; i = c) {                                       \
+      if (c + 1 < n && LESS(data[c], data[c + 1]))                             \
+        c++;                                                                   \
+      if (!LESS(x, data[c]))                                                   \
+        break;                                                                 \
+      data[i] = data[c];                                                       \
+    }                                                                          \
+    data[i] = x;                                                               \
+  }                                                                            \
+                                                                               \
+  static void SLOWSORT_MANGLE_F(NAME, _heap)(T * data, SLOWARR_SZT n)          \
+  {                                                                            \
+    SLOWARR_SZT i;                                                             \
+    T x;                                                                       \
+    for (i = n / 2; i > 0; i--)                                                \
+      SLOWSORT_MANGLE_F(NAME, _sift)(data, i - 1, n);                          \
+    for (i = n - 1; i > 0; i--) {                                              \
+      x = data[0];                                                             \
+      data[0] = data[i];                                                       \
+      data[i] = x;                                                             \
+      SLOWSORT_MANGLE_F(NAME, _sift)(data, 0, i);                              \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  /* leaves ranges of up to SLOWSORT_INSERTION_MAX elements unsorted */        \
+  static void SLOWSORT_MANGLE_F(NAME, _intro)(T * data, SLOWARR_SZT n,         \
+                                              unsigned depth)                  \
+  {                                                                            \
+    SLOWARR_SZT i, j, mid;                                                     \
+    T x, pivot;                                                                \
+    while (n > SLOWSORT_INSERTION_MAX) {                                       \
+      if (!depth--) {                                                          \
+        SLOWSORT_MANGLE_F(NAME, _heap)(data, n);                               \
+        return;                                                                \
+      }                                                                        \
+      /* median of three, sorted into first, mid and last */                   \
+      mid = n / 2;                                                             \
+      if (LESS(data[mid], data[0])) {                                          \
+        x = data[mid], data[mid] = data[0], data[0] = x;                       \
+      }                                                                        \
+      if (LESS(data[n - 1], data[mid])) {                                      \
+        x = data[mid], data[mid] = data[n - 1], data[n - 1] = x;               \
+        if (LESS(data[mid], data[0])) {                                        \
+          x = data[mid], data[mid] = data[0], data[0] = x;                     \
+        }                                                                      \
+      }                                                                        \
+      pivot = data[mid];                                                       \
+                                                                               \
+      /* hoare partition: first and last are sentinels */                      \
+      i = 0;                                                                   \
+      j = n - 1;                                                               \
+      for (;;) {                                                               \
+        do                                                                     \
+          i++;                                                                 \
+        while (LESS(data[i], pivot));                                          \
+        do                                                                     \
+          j--;                                                                 \
+        while (LESS(pivot, data[j]));                                          \
+        if (i >= j)                                                            \
+          break;                                                               \
+        x = data[i], data[i] = data[j], data[j] = x;                           \
+      }                                                                        \
+                                                                               \
+      /* recurse into the smaller half, to bound the stack depth */            \
+      if (j + 1 < n - j - 1) {                                                 \
+        SLOWSORT_MANGLE_F(NAME, _intro)(data, j + 1, depth);                   \
+        data += j + 1;                                                         \
+        n -= j + 1;                                                            \
+      } else {                                                                 \
+        SLOWSORT_MANGLE_F(NAME, _intro)(data + j + 1, n - j - 1, depth);       \
+        n = j + 1;                                                             \
+      }                                                                        \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC void SLOWSORT_MANGLE_F(NAME, sort)(T * data, SLOWARR_SZT n)     \
+  {                                                                            \
+    unsigned depth = 0;                                                        \
+    SLOWARR_SZT i;                                                             \
+    for (i = n; i > 1; i >>= 1)                                                \
+      depth += 2;                                                              \
+    SLOWSORT_MANGLE_F(NAME, _intro)(data, n, depth);                           \
+    SLOWSORT_MANGLE_F(NAME, _insertion)(data, n);                              \
+  }                                                                            \
+                                                                               \
+  SLOWARR_FUNC SLOWARR_SZT SLOWSORT_MANGLE_F(NAME, lowerBound)(T const* data,  \
+                                                               SLOWARR_SZT n,  \
+                                                               T key)          \
+  {                                                                            \
+    T const* base = data;                                                      \
+    SLOWARR_SZT half;                                                          \
+    if (!n)                                                                    \
+      return 0;                                                                \
+    /* the result is always in [base, base + n] */                             \
+    while (n > 1) {                                                            \
+      half = n / 2;                                                            \
+      base = LESS(base[half], key) ? base + half : base;                       \
+      n -= half;                                                               \
+    }                                                                          \
+    return (SLOWARR_SZT)(base - data) + (LESS(*base, key) ? 1 : 0);            \
+  }                                                                            \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+#define SLOWSORT_RadixHeader(NAME, T)                                          \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC void SLOWSORT_MANGLE_F(NAME, radixSort)(T * data, T * scratch,  \
+                                                       SLOWARR_SZT n);         \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+/** call this only once in your program. call SLOWSORT_RadixHeader first */
+#define SLOWSORT_RadixImpl(NAME, T, KEY, BYTES)                                \
+  SLOWARR_BEGINC                                                               \
+  SLOWARR_FUNC void SLOWSORT_MANGLE_F(NAME, radixSort)(T * data, T * scratch,  \
+                                                       SLOWARR_SZT n)          \
+  {                                                                            \
+    SLOWARR_SZT count[BYTES][256], i, sum, c;                                  \
+    T *src = data, *dst = scratch, *t;                                         \
+    unsigned b;                                                                \
+                                                                               \
+    /* all histograms in one pass */                                           \
+    SLOWARR_MEMZERO(count, sizeof(count));                                     \
+    for (i = 0; i < n; i++)                                                    \
+      for (b = 0; b < (BYTES); b++)                                            \
+        count[b][(KEY(data[i]) >> (b * 8)) & 0xFF]++;                          \
+                                                                               \
+    for (b = 0; b < (BYTES); b++) {                                            \
+      /* all elements have the same byte here: nothing to do */                \
+      if (n && count[b][(KEY(data[0]) >> (b * 8)) & 0xFF] == n)                \
+        continue;                                                              \
+      for (sum = 0, c = 0; c < 256; c++) {                                     \
+        i = count[b][c];                                                       \
+        count[b][c] = sum;                                                     \
+        sum += i;                                                              \
+      }                                                                        \
+      for (i = 0; i < n; i++)                                                  \
+        dst[count[b][(KEY(src[i]) >> (b * 8)) & 0xFF]++] = src[i];             \
+      t = src, src = dst, dst = t;                                             \
+    }                                                                          \
+    if (src != data)                                                           \
+      SLOWARR_MEMMOVE(data, src, n * sizeof(T));                               \
+  }                                                                            \
+  SLOWARR_ENDC                                                                 \
+  SLOWARR_REQUIRE_SEMI
+
+#endif
@@ -11,11 +11,16 @@
  * - SLOWCRYPT_SYSTEMRAND_IMPL
  * - SLOWCRYPT_SYSTEMRAND_FUNC
  *     will be used in front of every function definition / declaration
+ * - SLOWCRYPT_SYSTEMRAND_NO_VDSO
+ *     when building the library: don't use the vDSO getrandom
  *
  * Tries these sources (depending on platform support), in order:
- * - getentropy()
- * - getrandom()
- * - unless _WIN32 is defined, read from /dev/random or /dev/urandom
+ * - vDSO getrandom on Linux 6.11+, which does not need a syscall.
+ *   Every thread gets its own state on first use, reused after the thread exits
+ * - getrandom(), also called directly on Linux if the libc does not have it
+ * - getentropy(), if getrandom() is not available
+ * - unless _WIN32 is defined, read from /dev/random or /dev/urandom.
+ *   The file is opened once and then kept open.
  * - on _WIN32, try BCryptGenRandom
  * - on _WIN32, try RtlGenRandom
  * - on _WIN32, try CryptGenRandom
@@ -50,6 +55,8 @@
 #define SLOWCRYPT_SYSTEMRAND_FUNC /**/
 #endif
 
+#include "io.h"
+
 typedef enum
 {
   SLOWCRYPT_SYSTEMRAND__BAIL_IF_INSECURE = 1 << 0,
@@ -67,4 +74,46 @@ SLOWCRYPT_SYSTEMRAND_FUNC int slowcrypt_systemrand(
     unsigned long length,
     slowcrypt_systemrand_flags flags);
 
+/*
+ * Whether slowcrypt_systemrand() without INSECURE_NON_BLOCKING can return
+ * secure random numbers right now, without blocking.
+ * This is only not the case early at boot,
+ * before the kernel's pool is initialized.
+ *
+ * Return codes:
+ * - SLOWLIBS_IO_OK
+ * - SLOWLIBS_IO_WOULD_BLOCK: wait for slowcrypt_systemrand_poll_fd(), or try later
+ */
+SLOWCRYPT_SYSTEMRAND_FUNC slowlibs_io_status slowcrypt_systemrand_ready(void);
+
+/*
+ * slowcrypt_systemrand(buffer, length, SLOWCRYPT_SYSTEMRAND__BAIL_IF_INSECURE),
+ * but returns SLOWLIBS_IO_WOULD_BLOCK instead of blocking.
+ *
+ * Return codes:
+ * - SLOWLIBS_IO_OK
+ * - SLOWLIBS_IO_WOULD_BLOCK: nothing written
+ * - SLOWLIBS_IO_EXTERNAL_ERROR: no secure source
+ */
+SLOWCRYPT_SYSTEMRAND_FUNC slowlibs_io_status slowcrypt_systemrand_try(
+    void* buffer,
+    unsigned long length);
+
+/*
+ * A file descriptor that becomes readable (POLLIN) once
+ * slowcrypt_systemrand_ready() returns SLOWLIBS_IO_OK,
+ * for adding to a poll / epoll / kqueue event loop.
+ * Owned by the library: do not read from or close it.
+ *
+ * Returns -1 if there is none, on platforms where the pool
+ * is always ready (Windows), or if it can not be opened.
+ *
+ * Example:
+ *     if (slowcrypt_systemrand_ready() == SLOWLIBS_IO_WOULD_BLOCK) {
+ *       struct pollfd p = { slowcrypt_systemrand_poll_fd(), POLLIN };
+ *       add p to the event loop, and serve other requests until it fires
+ *     }
+ */
+SLOWCRYPT_SYSTEMRAND_FUNC int slowcrypt_systemrand_poll_fd(void);
+
 #endif
@@ -21,6 +21,12 @@
 #define slowlibs_O0 /**/
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+#define slowlibs_prefetch(addr) __builtin_prefetch((addr))
+#else
+#define slowlibs_prefetch(addr) ((void)(addr))
+#endif
+
 // TODO
 #define slowlibs_ct_select(cond, a, b) ((cond) ? (a) : (b))
 
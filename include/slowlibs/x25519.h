@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Alexander Nutz
+ * 0BSD licensed, see below documentation
+ *
+ * Latest version can be found at:
+ * https://git.vxcc.dev/alexander.nutz/slow-libs
+ *
+ *
+ * ======== X25519 key exchange (RFC 7748) ========
+ *
+ * Security considerations:
+ * - manually zeroize memory (depending on your application)
+ * - check that the shared secret is not all zeros, if the other public key is not trusted
+ * - timing attacks:
+ *   Uses a constant-time Montgomery ladder. The conditional swaps are compiled
+ *   without optimizations, unless SLOWCRYPT_ALLOW_TIMING_ATTACKS is defined.
+ *
+ *
+ * Configuration options:
+ * - SLOWCRYPT_X25519_IMPL
+ * - SLOWCRYPT_X25519_FUNC
+ *     will be used in front of every function definition / declaration
+ * - SLOWCRYPT_GF25519_USE_32BIT
+ *     see gf25519.h
+ *
+ *
+ * Compatibility:
+ *   requires only a C99 compiler.
+ *
+ *
+ * Usage example: key exchange
+ *     uint8_t secret[32], public[32], shared[32];
+ *
+ *     fill secret with random bytes
+ *     slowcrypt_x25519_base(public, secret);
+ *     send public, receive other_public
+ *     slowcrypt_x25519(shared, secret, other_public);
+ *
+ *     # hash shared before using it as key, for example with KChaCha
+ */
+
+/*
+ * Copyright (C) 2026 by Alexander Nutz <alexander.nutz@vxcc.dev>
+ *
+ * Permission to use, copy, modify, and/or distribute this software
+ * for any purpose with or without fee is hereby granted.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES
+ * OF MERCHANTABILITY AND FITNESS.
+ * IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY SPECIAL, DIRECT, INDIRECT,
+ * OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES WHATSOEVER RESULTING FROM
+ * LOSS OF USE, DATA OR PROFITS, WHETHER IN AN ACTION OF CONTRACT,
+ * NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ * ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE
+ * OF THIS SOFTWARE.
+ */
+
+#ifndef SLOWCRYPT_X25519_H
+#define SLOWCRYPT_X25519_H
+
+#ifndef SLOWCRYPT_X25519_FUNC
+#define SLOWCRYPT_X25519_FUNC /**/
+#endif
+
+#include <stdint.h>
+#include "gf25519.h"
+#include "util.h"
+
+#ifndef slowcrypt_timing_sensitive
+#ifdef SLOWCRYPT_ALLOW_TIMING_ATTACKS
+#define slowcrypt_timing_sensitive /**/
+#else
+#define slowcrypt_timing_sensitive slowlibs_O0
+#endif
+#endif
+
+/* out = scalar * point (u-coordinates) */
+SLOWCRYPT_X25519_FUNC void slowcrypt_x25519(uint8_t out[32],
+                                            uint8_t const scalar[32],
+                                            uint8_t const point[32]);
+
+/* out = scalar * 9 (the public key of scalar) */
+SLOWCRYPT_X25519_FUNC void slowcrypt_x25519_base(uint8_t out[32],
+                                                 uint8_t const scalar[32]);
+
+#ifdef SLOWCRYPT_X25519_IMPL
+
+static void slowcrypt_timing_sensitive
+slowcrypt_x25519_cswap(slowcrypt_gf25519* a,
+                       slowcrypt_gf25519* b,
+                       unsigned swap)
+{
+  slowcrypt_gf25519_cswap(a, b, swap);
+}
+
+SLOWCRYPT_X25519_FUNC void slowcrypt_x25519(uint8_t out[32],
+                                            uint8_t const scalar[32],
+                                            uint8_t const point[32])
+{
+  slowcrypt_gf25519 x1, x2, z2, x3, z3;
+  slowcrypt_gf25519 a, aa, b, bb, e, c, d, da, cb;
+  uint8_t k[32];
+  unsigned swap = 0, bit;
+  int i;
+
+  for (i = 0; i < 32; i++)
+    k[i] = scalar[i];
+  k[0] &= 248;
+  k[31] &= 127;
+  k[31] |= 64;
+
+  slowcrypt_gf25519_frombytes(&x1, point);
+  slowcrypt_gf25519_one(&x2);
+  slowcrypt_gf25519_zero(&z2);
+  x3 = x1;
+  slowcrypt_gf25519_one(&z3);
+
+  for (i = 254; i >= 0; i--) {
+    bit = (k[i / 8] >> (i % 8)) & 1;
+    swap ^= bit;
+    slowcrypt_x25519_cswap(&x2, &x3, swap);
+    slowcrypt_x25519_cswap(&z2, &z3, swap);
+    swap = bit;
+
+    slowcrypt_gf25519_add(&a, &x2, &z2);
+    slowcrypt_gf25519_sqr(&aa, &a);
+    slowcrypt_gf25519_sub(&b, &x2, &z2);
+    slowcrypt_gf25519_sqr(&bb, &b);
+    slowcrypt_gf25519_sub(&e, &aa, &bb);
+    slowcrypt_gf25519_add(&c, &x3, &z3);
+    slowcrypt_gf25519_sub(&d, &x3, &z3);
+    slowcrypt_gf25519_mul(&da, &d, &a);
+    slowcrypt_gf25519_mul(&cb, &c, &b);
+
+    slowcrypt_gf25519_add(&x3, &da, &cb);
+    slowcrypt_gf25519_sqr(&x3, &x3);
+    slowcrypt_gf25519_sub(&z3, &da, &cb);
+    slowcrypt_gf25519_sqr(&z3, &z3);
+    slowcrypt_gf25519_mul(&z3, &x1, &z3);
+    slowcrypt_gf25519_mul(&x2, &aa, &bb);
+    slowcrypt_gf25519_mul_small(&z2, &e, 121665);
+    slowcrypt_gf25519_add(&z2, &aa, &z2);
+    slowcrypt_gf25519_mul(&z2, &e, &z2);
+  }
+  slowcrypt_x25519_cswap(&x2, &x3, swap);
+  slowcrypt_x25519_cswap(&z2, &z3, swap);
+
+  slowcrypt_gf25519_invert(&z2, &z2);
+  slowcrypt_gf25519_mul(&x2, &x2, &z2);
+  slowcrypt_gf25519_tobytes(out, &x2);
+
+  for (i = 0; i < 32; i++)
+    ((volatile uint8_t*)k)[i] = 0;
+}
+
+SLOWCRYPT_X25519_FUNC void slowcrypt_x25519_base(uint8_t out[32],
+                                                 uint8_t const scalar[32])
+{
+  static uint8_t const base[32] = {9};
+  slowcrypt_x25519(out, scalar, base);
+}
+
+#endif
+
+#endif
@@ -11,6 +11,13 @@
 #endif
 #include "slowlibs/util.h"
 
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#ifdef MAP_ANONYMOUS
+#define HAVE_MMAN
+#endif
+#endif
+
 static void* cat_u32(void* buf, uint32_t cnt)
 {
   memcpy(buf, &cnt, 4);
@@ -36,6 +43,17 @@ static void* cat_buf(void* buf, void const* src, unsigned num)
   return buf + num;
 }
 
+void slowcrypt_balloon_kchacha_init(slowcrypt_kchacha_ctx* pw,
+                                    uint8_t const protocol_constant[16],
+                                    unsigned kchacha_rounds)
+{
+  uint8_t cntbuf[4];
+
+  slowcrypt_kchacha_init(pw, protocol_constant, kchacha_rounds);
+  cat_u32(cntbuf, 0);
+  slowcrypt_kchacha_update(pw, cntbuf, 4);
+}
+
 int slowcrypt_balloon_kchacha(uint8_t out[32],
                               uint8_t const protocol_constant[16],
                               uint8_t const password[],
@@ -46,33 +64,250 @@ int slowcrypt_balloon_kchacha(uint8_t out[32],
                               unsigned balloon_rounds,
                               unsigned kchacha_rounds)
 {
-  uint8_t *buf, *blkbuf;
-  unsigned m, t, i, len;
-  uint32_t cnt = 0, random_buf_id;
-#if FULL_MOD
-  slowlib_fbig_var(32 * 8, yetanotherbuffer);
-  slowlib_fbig_var(8, somehowneedanotherbuffer);
+  slowcrypt_kchacha_ctx pw;
+
+  slowcrypt_balloon_kchacha_init(&pw, protocol_constant, kchacha_rounds);
+  slowcrypt_kchacha_update(&pw, password, password_len);
+  return slowcrypt_balloon_kchacha_final(out, &pw, salt, salt_len, buffer_size,
+                                         balloon_rounds);
+}
+
+#define HUGE_PAGE_SIZE (2 * 1024 * 1024)
+
+// u32(cnt) || salt || u32(t) || u32(m) || u32(i)
+#define SEL_LEN(salt_len) (4 + (salt_len) + 3 * 4)
+// blocks whose pseudo-random selections are computed together
+#define SEL_BLOCKS 8
+#define SEL_BATCH (SEL_BLOCKS * 3)
+
+int slowcrypt_balloon_kchacha_final(uint8_t out[32],
+                                    slowcrypt_kchacha_ctx* pw,
+                                    uint8_t const salt[],
+                                    unsigned salt_len,
+                                    unsigned buffer_size,
+                                    unsigned balloon_rounds)
+{
+  slowcrypt_balloon_kchacha_ctx ctx;
+  uint8_t scratch[32];
+
+  // huge pages cut TLB misses of the pseudo-random block reads
+  if (slowcrypt_balloon_kchacha_ctx_init(
+          &ctx, pw->protocol_constant, buffer_size, balloon_rounds, pw->rounds,
+          buffer_size >= HUGE_PAGE_SIZE ? SLOWCRYPT_BALLOON__HUGE_PAGES : 0)) {
+    slowcrypt_kchacha_final(pw, scratch);
+    return 1;
+  }
+
+  if (slowcrypt_balloon_kchacha_ctx_salt(&ctx, salt, salt_len)) {
+    slowcrypt_kchacha_final(pw, scratch);
+    slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+    return 1;
+  }
+
+  slowcrypt_balloon_kchacha_ctx_final(&ctx, out, pw);
+  slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+  return 0;
+}
+
+static uint8_t* buf_alloc(unsigned long len,
+                          unsigned long* mapped_len,
+                          slowcrypt_balloon_kchacha_flags flags)
+{
+#ifdef HAVE_MMAN
+  void* p;
+  unsigned long huge = HUGE_PAGE_SIZE;
+
+  if (flags & SLOWCRYPT_BALLOON__HUGE_PAGES) {
+    *mapped_len = (len + huge - 1) / huge * huge;
+
+#ifdef MAP_HUGETLB
+    p = mmap(0, *mapped_len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (p != MAP_FAILED)
+      return p;
+#endif
+
+    /* no reserved huge pages: fall back to transparent huge pages */
+    p = mmap(0, *mapped_len, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (p != MAP_FAILED) {
+#ifdef MADV_HUGEPAGE
+      madvise(p, *mapped_len, MADV_HUGEPAGE);
+#endif
+      return p;
+    }
+  }
 #else
-  uint8_t yetanotherbuffer[32];
+  (void)flags;
 #endif
 
-  buffer_size /= 32;
-  buf = malloc(buffer_size * 32);
-  if (!buf)
-    return 1;
+  *mapped_len = 0;
+  return malloc(len);
+}
+
+static void buf_free(uint8_t* buf, unsigned long mapped_len)
+{
+#ifdef HAVE_MMAN
+  if (mapped_len) {
+    munmap(buf, mapped_len);
+    return;
+  }
+#endif
+  free(buf);
+}
 
-  m = password_len + salt_len + 4 + 64;
-  blkbuf = malloc(m);
-  if (!blkbuf) {
-    free(buf);
+int slowcrypt_balloon_kchacha_ctx_init(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t const protocol_constant[16],
+                                       unsigned buffer_size,
+                                       unsigned balloon_rounds,
+                                       unsigned kchacha_rounds,
+                                       slowcrypt_balloon_kchacha_flags flags)
+{
+  memcpy(ctx->protocol_constant, protocol_constant, 16);
+  ctx->kchacha_rounds = kchacha_rounds;
+  ctx->buffer_size = buffer_size / 32;
+  ctx->balloon_rounds = balloon_rounds;
+  ctx->sel = 0;
+  ctx->salt_len = 0;
+  ctx->salt_cap = 0;
+
+  ctx->buf = buf_alloc((unsigned long)ctx->buffer_size * 32,
+                       &ctx->buf_mapped_len, flags);
+  if (!ctx->buf)
     return 1;
+
+  return 0;
+}
+
+int slowcrypt_balloon_kchacha_ctx_salt(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t const salt[],
+                                       unsigned salt_len)
+{
+  uint8_t* sel;
+  unsigned k;
+
+  if (salt_len > ctx->salt_cap || !ctx->sel) {
+    sel = malloc(SEL_LEN(salt_len) * SEL_BATCH);
+    if (!sel)
+      return 1;
+    if (ctx->sel) {
+      memset(ctx->sel, 0, SEL_LEN(ctx->salt_cap) * SEL_BATCH);
+      free(ctx->sel);
+    }
+    ctx->sel = sel;
+    ctx->salt_cap = salt_len;
   }
 
+  for (k = 0; k < SEL_BATCH; k++)
+    cat_buf(&ctx->sel[SEL_LEN(salt_len) * k + 4], salt, salt_len);
+  ctx->salt_len = salt_len;
+  return 0;
+}
+
+void slowcrypt_balloon_kchacha_ctx_run(slowcrypt_balloon_kchacha_ctx* ctx,
+                                       uint8_t out[32],
+                                       uint8_t const password[],
+                                       unsigned password_len)
+{
+  slowcrypt_kchacha_ctx pw;
+
+  slowcrypt_balloon_kchacha_init(&pw, ctx->protocol_constant,
+                                 ctx->kchacha_rounds);
+  slowcrypt_kchacha_update(&pw, password, password_len);
+  slowcrypt_balloon_kchacha_ctx_final(ctx, out, &pw);
+}
+
+static uint32_t hash_to_block_id(slowcrypt_balloon_kchacha_ctx* ctx,
+                                 uint8_t hash[32])
+{
+#if FULL_MOD
+  slowlib_fbig_var(32 * 8, hashnum);
+  slowlib_fbig_var(32 * 8, quot);
+  slowlib_fbig_var(32, mod);
+  slowlib_fbig_var(32, rem);
+
+  memcpy(hashnum, hash, 32);
+  slowlib_fbig_zext_scalar(mod, ctx->buffer_size);
+  // always written by udivmod, but gcc can't see that
+  slowlib_fbig_zext_scalar(rem, 0);
+  // the block ids are not secret: single part division
+  slowlib_fbig_udivmod_vt(quot, rem, hashnum, mod);
+  return (uint32_t)rem[0];
+#else
+  if (SLOWLIBS_ENDIAN_HOST != SLOWLIBS_ENDIAN_LITTLE) {
+    slowlibs_memrevcpy_inplace(hash, 4);
+  }
+  return *(uint32_t*)(void*)hash % ctx->buffer_size;
+#endif
+}
+
+// each mixed block uses 7 counter values:
+//   2a, then (selection, mix) for each of the 3 pseudo-random blocks
+#define CNT_PER_BLOCK 7
+
+// Step 2b pseudo-random block selection, for the blocks m0 .. m0 + nblocks.
+//
+// Selection only depends on the counter, salt, t, m and i, but not on the
+// buffer contents, which is what makes it possible to compute it ahead of time,
+// and for many blocks at once, with slowcrypt_kchacha_many().
+//
+// `cnt` is the counter at the start of block m0.
+// The salt and t are already in place in the selection messages.
+static void select_blocks(slowcrypt_balloon_kchacha_ctx* ctx,
+                          uint32_t cnt,
+                          unsigned m0,
+                          unsigned nblocks,
+                          uint32_t ids[SEL_BLOCKS][3])
+{
+  uint8_t hashes[SEL_BATCH][32];
+  uint8_t const* msgs[SEL_BATCH] = {0};
+  unsigned lens[SEL_BATCH] = {0};
+  unsigned sel_len = SEL_LEN(ctx->salt_len);
+  unsigned b, i, k;
+  uint8_t* sel;
+
+  for (b = 0; b < nblocks; b++) {
+    for (i = 0; i < 3; i++) {
+      k = b * 3 + i;
+      sel = &ctx->sel[sel_len * k];
+      cat_u32(sel, cnt + CNT_PER_BLOCK * b + 1 + 2 * i);
+      cat_u32(&sel[4 + ctx->salt_len + 4], m0 + b);
+      cat_u32(&sel[4 + ctx->salt_len + 8], i);
+      msgs[k] = sel;
+      lens[k] = sel_len;
+    }
+  }
+
+  slowcrypt_kchacha_many(hashes, ctx->protocol_constant, msgs, lens,
+                         nblocks * 3, ctx->kchacha_rounds);
+
+  for (b = 0; b < nblocks; b++)
+    for (i = 0; i < 3; i++)
+      ids[b][i] = hash_to_block_id(ctx, hashes[b * 3 + i]);
+
+  for (k = 0; k < SEL_BATCH; k++)
+    for (i = 0; i < 32; i++)
+      ((volatile uint8_t*)hashes[k])[i] = 0;
+}
+
+void slowcrypt_balloon_kchacha_ctx_final(slowcrypt_balloon_kchacha_ctx* ctx,
+                                         uint8_t out[32],
+                                         slowcrypt_kchacha_ctx* pw)
+{
+  uint8_t* buf = ctx->buf;
+  uint8_t const* protocol_constant = ctx->protocol_constant;
+  unsigned buffer_size = ctx->buffer_size;
+  unsigned sel_len = SEL_LEN(ctx->salt_len);
+  int kchacha_rounds = ctx->kchacha_rounds;
+  uint8_t blkbuf[4 + 32 + 32];
+  unsigned m, t, i, k, b, nblocks, next_nblocks;
+  uint32_t cnt = 1, random_buf_id[SEL_BLOCKS][3],
+           next_random_buf_id[SEL_BLOCKS][3];
+
   // Step 1: Expand input into buffer
-  cat_buf(cat_buf(cat_inc_u32(blkbuf, &cnt), password, password_len), salt,
-          salt_len);
-  slowcrypt_kchacha(&buf[0], protocol_constant, blkbuf,
-                    4 + password_len + salt_len, kchacha_rounds);
+  // (counter 0 and the password have already been absorbed into pw)
+  slowcrypt_kchacha_update(pw, &ctx->sel[4], ctx->salt_len);
+  slowcrypt_kchacha_final(pw, &buf[0]);
 
   for (m = 1; m < buffer_size; m++) {
     cat_buf(cat_inc_u32(blkbuf, &cnt), &buf[(m - 1) * 32], 32);
@@ -81,59 +316,75 @@ int slowcrypt_balloon_kchacha(uint8_t out[32],
   }
 
   // Step 2: Mix buffer contents
-  for (t = 0; t < balloon_rounds; t++) {
-    for (m = 0; m < buffer_size; m++) {
-      // Step 2a: hash last and current blocks
-      cat_buf(cat_buf(cat_inc_u32(blkbuf, &cnt),
-                      &buf[((m - 1) % buffer_size) * 32], 32),
-              &buf[m * 32], 32);
-      slowcrypt_kchacha(&buf[m * 32], protocol_constant, blkbuf, 4 + 32 + 32,
-                        kchacha_rounds);
-
-      // Step 2b: Hash in pseudorandom chosen blocks
-      for (i = 0; i < 3; i++) {
-        // fuck you (you, the person who has to suffer reading this code)
-        len = cat_u32(cat_u32(cat_u32(cat_buf(cat_inc_u32(blkbuf, &cnt), salt,
-                                              salt_len),
-                                      t),
-                              m),
-                      i) -
-              (void*)blkbuf;
-#if FULL_MOD
-        slowcrypt_kchacha((void*)yetanotherbuffer, protocol_constant, blkbuf,
-                          len, kchacha_rounds);
-
-        slowlib_fbig_zext_scalar(somehowneedanotherbuffer, buffer_size);
-        slowlib_fbig_umod(yetanotherbuffer, yetanotherbuffer,
-                          somehowneedanotherbuffer);
-        if (SLOWLIBS_ENDIAN_HOST != SLOWLIBS_ENDIAN_LITTLE) {
-          slowlibs_memrevcpy_inplace(yetanotherbuffer, sizeof yetanotherbuffer);
-        }
-        random_buf_id = *(uint32_t*)(void*)yetanotherbuffer;
-#else
-        slowcrypt_kchacha((void*)yetanotherbuffer, protocol_constant, blkbuf,
-                          len, kchacha_rounds);
-        if (SLOWLIBS_ENDIAN_HOST != SLOWLIBS_ENDIAN_LITTLE) {
-          slowlibs_memrevcpy_inplace(yetanotherbuffer, 4);
-        }
-        random_buf_id = *(uint32_t*)(void*)yetanotherbuffer % buffer_size;
-#endif
+  for (t = 0; t < ctx->balloon_rounds; t++) {
+    for (k = 0; k < SEL_BATCH; k++)
+      cat_u32(&ctx->sel[sel_len * k + 4 + ctx->salt_len], t);
+
+    next_nblocks = buffer_size < SEL_BLOCKS ? buffer_size : SEL_BLOCKS;
+    select_blocks(ctx, cnt, 0, next_nblocks, next_random_buf_id);
+
+    for (m = 0; m < buffer_size; m += nblocks) {
+      nblocks = next_nblocks;
+      memcpy(random_buf_id, next_random_buf_id, sizeof random_buf_id);
+
+      // Software pipeline: select (and prefetch) the pseudo-random blocks of
+      // the next group of blocks, so the cache misses overlap with hashing
+      // this group.
+      next_nblocks = buffer_size - (m + nblocks);
+      if (next_nblocks > SEL_BLOCKS)
+        next_nblocks = SEL_BLOCKS;
+      if (next_nblocks) {
+        select_blocks(ctx, cnt + CNT_PER_BLOCK * nblocks, m + nblocks,
+                      next_nblocks, next_random_buf_id);
+        for (b = 0; b < next_nblocks; b++)
+          for (i = 0; i < 3; i++)
+            slowlibs_prefetch(&buf[next_random_buf_id[b][i] * 32]);
+      }
 
-        len = cat_buf(cat_buf(cat_inc_u32(blkbuf, &cnt), &buf[32 * m], 32),
-                      &buf[random_buf_id * 32], 32) -
-              (void*)blkbuf;
-        slowcrypt_kchacha(&buf[32 * m], protocol_constant, blkbuf, len,
-                          kchacha_rounds);
+      for (b = 0; b < nblocks; b++) {
+        // Step 2a: hash last and current blocks
+        cat_buf(cat_buf(cat_inc_u32(blkbuf, &cnt),
+                        &buf[((m + b - 1) % buffer_size) * 32], 32),
+                &buf[(m + b) * 32], 32);
+        slowcrypt_kchacha(&buf[(m + b) * 32], protocol_constant, blkbuf,
+                          4 + 32 + 32, kchacha_rounds);
+
+        // Step 2b: Hash in pseudorandom chosen blocks
+        for (i = 0; i < 3; i++) {
+          cnt++;  // used by select_blocks()
+
+          cat_buf(cat_buf(cat_inc_u32(blkbuf, &cnt), &buf[32 * (m + b)], 32),
+                  &buf[random_buf_id[b][i] * 32], 32);
+          slowcrypt_kchacha(&buf[32 * (m + b)], protocol_constant, blkbuf,
+                            4 + 32 + 32, kchacha_rounds);
+        }
       }
     }
   }
 
   for (m = 0; m < 32; m++)
     out[m] = buf[(buffer_size - 1) * 32 + m];
-  free(buf);
 
-  for (i = 0; i < 32; i++)
-    ((volatile uint8_t*)yetanotherbuffer)[i] = 0;
+  for (i = 0; i < sizeof blkbuf; i++)
+    ((volatile uint8_t*)blkbuf)[i] = 0;
+}
 
-  return 0;
+void slowcrypt_balloon_kchacha_ctx_deinit(slowcrypt_balloon_kchacha_ctx* ctx)
+{
+  unsigned long i;
+
+  if (ctx->buf) {
+    for (i = 0; i < (unsigned long)ctx->buffer_size * 32; i++)
+      ((volatile uint8_t*)ctx->buf)[i] = 0;
+    buf_free(ctx->buf, ctx->buf_mapped_len);
+  }
+
+  if (ctx->sel) {
+    for (i = 0; i < SEL_LEN(ctx->salt_cap) * SEL_BATCH; i++)
+      ((volatile uint8_t*)ctx->sel)[i] = 0;
+    free(ctx->sel);
+  }
+
+  ctx->buf = 0;
+  ctx->sel = 0;
 }
@@ -0,0 +1,129 @@
+
+// Balloon-KChaCha parameter auto-calibration.
+//
+// Cost model: one hash costs roughly
+//   blocks * (1 + 7 * balloon_rounds)
+// KChaCha calls, where blocks = buffer_size / 32.
+
+#include <limits.h>
+#include <stdint.h>
+#include <time.h>
+#include "slowlibs/chacha20.h"
+
+#define PROBE_SIZE (1024 * 1024)
+#define MIN_SIZE (64 * 1024)
+#define MAX_VERIFY_STEPS 8
+
+static uint8_t const calib_constant[16] = {0xca, 0x11, 0xb7, 0xa7, 0xe0};
+
+static double now_ms(void)
+{
+#if defined(CLOCK_MONOTONIC) && !defined(_WIN32)
+  struct timespec ts;
+  if (!clock_gettime(CLOCK_MONOTONIC, &ts))
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+#endif
+  return clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+/* converting a double that doesn't fit is undefined */
+static unsigned to_unsigned(double x)
+{
+  if (x >= (double)UINT_MAX)
+    return UINT_MAX;
+  return x > 0 ? (unsigned)x : 0;
+}
+
+static double cost(unsigned buffer_size, unsigned balloon_rounds)
+{
+  return (double)(buffer_size / 32) * (1.0 + 7.0 * balloon_rounds);
+}
+
+static int measure(double* ms,
+                   unsigned buffer_size,
+                   unsigned balloon_rounds,
+                   unsigned kchacha_rounds)
+{
+  slowcrypt_balloon_kchacha_ctx ctx;
+  uint8_t out[32];
+  double start;
+
+  if (slowcrypt_balloon_kchacha_ctx_init(&ctx, calib_constant, buffer_size,
+                                         balloon_rounds, kchacha_rounds,
+                                         SLOWCRYPT_BALLOON__HUGE_PAGES))
+    return 1;
+  if (slowcrypt_balloon_kchacha_ctx_salt(&ctx, calib_constant, 16)) {
+    slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+    return 1;
+  }
+
+  start = now_ms();
+  slowcrypt_balloon_kchacha_ctx_run(&ctx, out, calib_constant, 16);
+  *ms = now_ms() - start;
+
+  slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+  return 0;
+}
+
+int slowcrypt_balloon_kchacha_calibrate(slowcrypt_balloon_kchacha_params* out,
+                                        unsigned target_ms,
+                                        unsigned long max_mem,
+                                        unsigned kchacha_rounds)
+{
+  double ms, per_op, fits;
+  unsigned buffer_size, balloon_rounds, step;
+
+  if (max_mem > UINT_MAX)
+    max_mem = UINT_MAX;
+  max_mem = max_mem / 32 * 32;
+  if (max_mem < MIN_SIZE || !target_ms)
+    return 2;
+
+  // Step 1: estimate the cost of one KChaCha call in the balloon loop
+  buffer_size = max_mem < PROBE_SIZE ? (unsigned)max_mem : PROBE_SIZE;
+  if (measure(&ms, buffer_size, 1, kchacha_rounds))
+    return 1;
+  per_op = ms / cost(buffer_size, 1);
+  if (per_op <= 0)
+    per_op = 1e-6;
+
+  // Step 2: use as much memory as possible, spend the rest on rounds
+  fits = target_ms / per_op;
+  if (cost(max_mem, 1) <= fits) {
+    buffer_size = max_mem;
+    balloon_rounds = to_unsigned((fits / (max_mem / 32) - 1.0) / 7.0);
+  } else {
+    buffer_size = to_unsigned(fits / 8.0) * 32;
+    balloon_rounds = 1;
+  }
+  if (balloon_rounds < 1)
+    balloon_rounds = 1;
+
+  // Step 3: verify the prediction, and back off until it fits
+  for (step = 0;; step++) {
+    if (buffer_size < MIN_SIZE)
+      return 2;
+    if (measure(&ms, buffer_size, balloon_rounds, kchacha_rounds))
+      return 1;
+    if (ms <= target_ms)
+      break;
+    if (step == MAX_VERIFY_STEPS)
+      return 2;
+
+    if (balloon_rounds > 1) {
+      balloon_rounds = to_unsigned(balloon_rounds * (target_ms / ms));
+      if (balloon_rounds < 1)
+        balloon_rounds = 1;
+    } else {
+      buffer_size =
+          to_unsigned(buffer_size * (target_ms / ms) * 0.95) / 32 * 32;
+    }
+  }
+
+  out->buffer_size = buffer_size;
+  out->balloon_rounds = balloon_rounds;
+  out->kchacha_rounds = kchacha_rounds;
+  out->ms_per_hash = ms;
+  out->hashes_per_sec = ms > 0 ? 1000.0 / ms : 0;
+  return 0;
+}
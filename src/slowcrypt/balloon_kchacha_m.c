@@ -0,0 +1,191 @@
+
+// Balloon-M style parallel Balloon-KChaCha:
+//   out_l = balloon(password, salt || u32(l))   for l in 1..=lanes
+//   out   = kchacha(u32(0) || password || salt || u32(0) || xor(out_l))
+
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "slowlibs/chacha20.h"
+
+#if defined(_WIN32)
+#include <windows.h>
+#define HAVE_WIN32_THREADS
+#elif defined(unix) || defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define HAVE_PTHREAD
+#endif
+
+struct lane
+{
+  slowcrypt_kchacha_ctx pw;
+  uint8_t* salt;
+  unsigned salt_len;
+  unsigned buffer_size;
+  unsigned balloon_rounds;
+  uint8_t out[32];
+  int rc;
+#if defined(HAVE_PTHREAD)
+  pthread_t thread;
+#elif defined(HAVE_WIN32_THREADS)
+  HANDLE thread;
+#endif
+  int spawned;
+};
+
+static void write_u32_le(uint8_t buf[4], uint32_t val)
+{
+  buf[0] = (uint8_t)(val & 0xFF);
+  buf[1] = (uint8_t)((val >> 8) & 0xFF);
+  buf[2] = (uint8_t)((val >> 16) & 0xFF);
+  buf[3] = (uint8_t)((val >> 24) & 0xFF);
+}
+
+static void run_lane(struct lane* lane)
+{
+  lane->rc = slowcrypt_balloon_kchacha_final(
+      lane->out, &lane->pw, lane->salt, lane->salt_len, lane->buffer_size,
+      lane->balloon_rounds);
+}
+
+#if defined(HAVE_PTHREAD)
+static void* lane_thread(void* arg)
+{
+  run_lane(arg);
+  return 0;
+}
+#elif defined(HAVE_WIN32_THREADS)
+static DWORD WINAPI lane_thread(LPVOID arg)
+{
+  run_lane(arg);
+  return 0;
+}
+#endif
+
+static void lane_spawn(struct lane* lane)
+{
+  lane->spawned = 0;
+#if defined(HAVE_PTHREAD)
+  lane->spawned = !pthread_create(&lane->thread, 0, lane_thread, lane);
+#elif defined(HAVE_WIN32_THREADS)
+  lane->thread = CreateThread(0, 0, lane_thread, lane, 0, 0);
+  lane->spawned = lane->thread != 0;
+#endif
+  /* no threads available: just run it on this one */
+  if (!lane->spawned)
+    run_lane(lane);
+}
+
+static void lane_join(struct lane* lane)
+{
+  if (!lane->spawned)
+    return;
+#if defined(HAVE_PTHREAD)
+  pthread_join(lane->thread, 0);
+#elif defined(HAVE_WIN32_THREADS)
+  WaitForSingleObject(lane->thread, INFINITE);
+  CloseHandle(lane->thread);
+#endif
+}
+
+int slowcrypt_balloon_kchacha_parallel(uint8_t out[32],
+                                       uint8_t const protocol_constant[16],
+                                       uint8_t const password[],
+                                       unsigned password_len,
+                                       uint8_t const salt[],
+                                       unsigned salt_len,
+                                       unsigned buffer_size,
+                                       unsigned balloon_rounds,
+                                       unsigned kchacha_rounds,
+                                       unsigned lanes)
+{
+  slowcrypt_kchacha_ctx pw;
+
+  slowcrypt_balloon_kchacha_init(&pw, protocol_constant, kchacha_rounds);
+  slowcrypt_kchacha_update(&pw, password, password_len);
+  return slowcrypt_balloon_kchacha_parallel_final(
+      out, &pw, salt, salt_len, buffer_size, balloon_rounds, lanes);
+}
+
+int slowcrypt_balloon_kchacha_parallel_final(uint8_t out[32],
+                                             slowcrypt_kchacha_ctx* pw,
+                                             uint8_t const salt[],
+                                             unsigned salt_len,
+                                             unsigned buffer_size,
+                                             unsigned balloon_rounds,
+                                             unsigned lanes)
+{
+  struct lane* lane;
+  uint8_t* salts;
+  uint8_t lanebuf[4], acc[32];
+  size_t salt_size = (size_t)salt_len + 4, z;
+  unsigned l, i;
+  int rc = 0, too_large;
+
+  if (lanes == 0)
+    lanes = 1;
+
+  /* the sizes below would overflow */
+  too_large = salt_len > UINT_MAX - 4 || lanes > SIZE_MAX / salt_size;
+#if SIZE_MAX <= UINT_MAX
+  /* with a wider size_t, lanes * sizeof(struct lane) always fits */
+  too_large = too_large || lanes > SIZE_MAX / sizeof(struct lane);
+#endif
+  if (too_large) {
+    slowcrypt_kchacha_final(pw, acc);
+    return 1;
+  }
+
+  lane = malloc(sizeof(struct lane) * lanes);
+  salts = malloc(salt_size * lanes);
+  if (!lane || !salts) {
+    free(lane);
+    free(salts);
+    slowcrypt_kchacha_final(pw, acc);
+    return 1;
+  }
+
+  for (l = 0; l < lanes; l++) {
+    lane[l].pw = *pw;
+    lane[l].salt = &salts[salt_size * l];
+    memcpy(lane[l].salt, salt, salt_len);
+    write_u32_le(&lane[l].salt[salt_len], l + 1);
+    lane[l].salt_len = salt_len + 4;
+    lane[l].buffer_size = buffer_size;
+    lane[l].balloon_rounds = balloon_rounds;
+  }
+
+  /* the last lane runs on the calling thread */
+  for (l = 0; l + 1 < lanes; l++)
+    lane_spawn(&lane[l]);
+  run_lane(&lane[lanes - 1]);
+  lane[lanes - 1].spawned = 0;
+
+  for (i = 0; i < 32; i++)
+    acc[i] = 0;
+
+  for (l = 0; l < lanes; l++) {
+    lane_join(&lane[l]);
+    if (lane[l].rc)
+      rc = lane[l].rc;
+    for (i = 0; i < 32; i++)
+      acc[i] ^= lane[l].out[i];
+  }
+
+  // combine: pw already contains u32(0) || password
+  write_u32_le(lanebuf, 0);
+  slowcrypt_kchacha_update(pw, salt, salt_len);
+  slowcrypt_kchacha_update(pw, lanebuf, 4);
+  slowcrypt_kchacha_update(pw, acc, 32);
+  slowcrypt_kchacha_final(pw, out);
+
+  for (z = 0; z < sizeof(struct lane) * lanes; z++)
+    ((volatile uint8_t*)lane)[z] = 0;
+  for (i = 0; i < 32; i++)
+    ((volatile uint8_t*)acc)[i] = 0;
+  free(lane);
+  free(salts);
+
+  return rc;
+}
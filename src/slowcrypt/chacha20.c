@@ -178,52 +178,81 @@ void slowcrypt_chacha20_poly1305_key_gen(uint8_t out[32],
   slowcrypt_chacha20_deinit(&state2);
 }
 
-void slowcrypt_kchacha(uint8_t state[32],
-                       uint8_t const protocol_constant[16],
-                       uint8_t const data[],
-                       unsigned data_len,
-                       int rounds)
+static void slowcrypt_kchacha_block(slowcrypt_kchacha_ctx* ctx)
 {
-  int i, chunk_len;
-  slowcrypt_chacha20 cstate;
-  uint8_t swap[32];
-  int add_trailing_block = 1;
+  int i;
 
   for (i = 0; i < 32; i++)
-    state[i] = 0;
-
-  for (; (int)data_len >= 0; data_len -= 32, data += 32) {
-    chunk_len = data_len;
-    if (chunk_len > 32)
-      chunk_len = 32;
+    ctx->chunk[i] ^= ctx->state[i];
 
-    for (i = 0; i < chunk_len; i++)
-      swap[i] = data[i];
-    for (; i < 31; i++)
-      swap[i] = 0;
+  slowcrypt_hchacha(&ctx->cstate, ctx->chunk, ctx->protocol_constant,
+                    ctx->state, ctx->rounds);
+  ctx->chunk_len = 0;
+}
 
-    if (chunk_len != 32) {
-      add_trailing_block = 0;
-      swap[31] = 32 - chunk_len;
-    }
+void slowcrypt_kchacha_init(slowcrypt_kchacha_ctx* ctx,
+                            uint8_t const protocol_constant[16],
+                            int rounds)
+{
+  int i;
 
-    for (i = 0; i < 32; i++)
-      swap[i] ^= state[i];
+  for (i = 0; i < 32; i++)
+    ctx->state[i] = 0;
+  for (i = 0; i < 16; i++)
+    ctx->protocol_constant[i] = protocol_constant[i];
+  ctx->chunk_len = 0;
+  ctx->rounds = rounds;
+}
 
-    slowcrypt_hchacha(&cstate, swap, protocol_constant, state, rounds);
+void slowcrypt_kchacha_update(slowcrypt_kchacha_ctx* ctx,
+                              uint8_t const data[],
+                              unsigned long data_len)
+{
+  unsigned i, n;
+
+  /* full chunks are hashed as-is, so they can be processed right away */
+  while (data_len) {
+    n = 32 - ctx->chunk_len;
+    if (n > data_len)
+      n = data_len;
+
+    for (i = 0; i < n; i++)
+      ctx->chunk[ctx->chunk_len + i] = data[i];
+    ctx->chunk_len += n;
+    data += n;
+    data_len -= n;
+
+    if (ctx->chunk_len == 32)
+      slowcrypt_kchacha_block(ctx);
   }
+}
 
-  if (add_trailing_block) {
-    for (; i < 31; i++)
-      swap[i] = state[i];
-    swap[31] = 32 ^ state[i];
+void slowcrypt_kchacha_final(slowcrypt_kchacha_ctx* ctx, uint8_t out[32])
+{
+  unsigned i;
 
-    slowcrypt_hchacha(&cstate, swap, protocol_constant, state, rounds);
-  }
+  /* ANSI X9.23 padding. A full trailing padding chunk if input is aligned */
+  for (i = ctx->chunk_len; i < 31; i++)
+    ctx->chunk[i] = 0;
+  ctx->chunk[31] = 32 - ctx->chunk_len;
+  slowcrypt_kchacha_block(ctx);
 
-  slowcrypt_chacha20_deinit(&cstate);
   for (i = 0; i < 32; i++)
-    ((volatile uint8_t*)swap)[i] = 0;
-  *(volatile int*)&chunk_len = 0;
-  *(volatile int*)&add_trailing_block = 0;
+    out[i] = ctx->state[i];
+
+  for (i = 0; i < sizeof(*ctx); i++)
+    ((volatile uint8_t*)ctx)[i] = 0;
+}
+
+void slowcrypt_kchacha(uint8_t out[32],
+                       uint8_t const protocol_constant[16],
+                       uint8_t const data[],
+                       unsigned data_len,
+                       int rounds)
+{
+  slowcrypt_kchacha_ctx ctx;
+
+  slowcrypt_kchacha_init(&ctx, protocol_constant, rounds);
+  slowcrypt_kchacha_update(&ctx, data, data_len);
+  slowcrypt_kchacha_final(&ctx, out);
 }
@@ -0,0 +1,239 @@
+#include <slowlibs/chacha20.h>
+
+// Batched HChaCha / KChaCha.
+//
+// State is stored transposed: vector `x[w]` holds state word `w` of all 8
+// lanes, so every quarter round operates on 8 independent messages at once.
+// Uses GCC / clang vector extensions; on x86 an AVX2 build of the same code
+// is selected at runtime.
+
+#if defined(__GNUC__) || defined(__clang__)
+#define HAVE_VECTOR_EXT
+#endif
+
+#if defined(HAVE_VECTOR_EXT) && (defined(__x86_64__) || defined(__i386__))
+#define HAVE_X86_DISPATCH
+#endif
+
+static uint32_t read_ul32(uint8_t const* buf)
+{
+  return (uint32_t)buf[0] | ((uint32_t)buf[1] << 8) |
+         ((uint32_t)buf[2] << 16) | ((uint32_t)buf[3] << 24);
+}
+
+static void write_ul32(uint8_t* buf, uint32_t val)
+{
+  buf[0] = (uint8_t)(val & 0xFF);
+  buf[1] = (uint8_t)((val >> 8) & 0xFF);
+  buf[2] = (uint8_t)((val >> 16) & 0xFF);
+  buf[3] = (uint8_t)((val >> 24) & 0xFF);
+}
+
+#ifdef HAVE_VECTOR_EXT
+
+typedef uint32_t slowcrypt_v8u32 __attribute__((vector_size(32)));
+
+#define ROLV(v, by) (((v) << (by)) | ((v) >> (32 - (by))))
+
+#define QROUNDV(x, a, b, c, d) \
+  do {                         \
+    x[a] += x[b];              \
+    x[d] ^= x[a];              \
+    x[d] = ROLV(x[d], 16);     \
+                               \
+    x[c] += x[d];              \
+    x[b] ^= x[c];              \
+    x[b] = ROLV(x[b], 12);     \
+                               \
+    x[a] += x[b];              \
+    x[d] ^= x[a];              \
+    x[d] = ROLV(x[d], 8);      \
+                               \
+    x[c] += x[d];              \
+    x[b] ^= x[c];              \
+    x[b] = ROLV(x[b], 7);      \
+  } while (0)
+
+static inline __attribute__((always_inline)) void hchacha_x8_core(
+    uint8_t hash[8][32],
+    uint8_t const key[8][32],
+    uint8_t const nonce[8][16],
+    int rounds)
+{
+  slowcrypt_v8u32 x[16];
+  int i, l;
+
+  for (l = 0; l < 8; l++) {
+    x[0][l] = 0x61707865;
+    x[1][l] = 0x3320646e;
+    x[2][l] = 0x79622d32;
+    x[3][l] = 0x6b206574;
+    for (i = 0; i < 8; i++)
+      x[4 + i][l] = read_ul32(&key[l][i * 4]);
+    for (i = 0; i < 4; i++)
+      x[12 + i][l] = read_ul32(&nonce[l][i * 4]);
+  }
+
+  for (i = 0; i < rounds; i++) {
+    if (i % 2 == 0) {
+      /* column round */
+      QROUNDV(x, 0, 4, 8, 12);
+      QROUNDV(x, 1, 5, 9, 13);
+      QROUNDV(x, 2, 6, 10, 14);
+      QROUNDV(x, 3, 7, 11, 15);
+    } else {
+      /* diagonal round */
+      QROUNDV(x, 0, 5, 10, 15);
+      QROUNDV(x, 1, 6, 11, 12);
+      QROUNDV(x, 2, 7, 8, 13);
+      QROUNDV(x, 3, 4, 9, 14);
+    }
+  }
+
+  for (l = 0; l < 8; l++) {
+    for (i = 0; i < 4; i++)
+      write_ul32(&hash[l][i * 4], x[i][l]);
+    for (i = 0; i < 4; i++)
+      write_ul32(&hash[l][i * 4 + 16], x[i + 12][l]);
+  }
+
+  for (i = 0; i < 16; i++)
+    *(volatile slowcrypt_v8u32*)&x[i] = (slowcrypt_v8u32){0};
+}
+
+static void hchacha_x8_generic(uint8_t hash[8][32],
+                               uint8_t const key[8][32],
+                               uint8_t const nonce[8][16],
+                               int rounds)
+{
+  hchacha_x8_core(hash, key, nonce, rounds);
+}
+
+#ifdef HAVE_X86_DISPATCH
+__attribute__((target("avx2"))) static void hchacha_x8_avx2(
+    uint8_t hash[8][32],
+    uint8_t const key[8][32],
+    uint8_t const nonce[8][16],
+    int rounds)
+{
+  hchacha_x8_core(hash, key, nonce, rounds);
+}
+#endif
+
+#else
+
+static void hchacha_x8_generic(uint8_t hash[8][32],
+                               uint8_t const key[8][32],
+                               uint8_t const nonce[8][16],
+                               int rounds)
+{
+  slowcrypt_chacha20 state;
+  int l;
+
+  for (l = 0; l < 8; l++)
+    slowcrypt_hchacha(&state, key[l], nonce[l], hash[l], rounds);
+  slowcrypt_chacha20_deinit(&state);
+}
+
+#endif
+
+void slowcrypt_hchacha_x8(uint8_t hash[8][32],
+                          uint8_t const key[8][32],
+                          uint8_t const nonce[8][16],
+                          int rounds)
+{
+#ifdef HAVE_X86_DISPATCH
+  /* called from several threads: racing initializations store the same */
+  static int have_avx2_cache = -1;
+  int have_avx2 = __atomic_load_n(&have_avx2_cache, __ATOMIC_RELAXED);
+  if (have_avx2 < 0) {
+    __builtin_cpu_init();
+    have_avx2 = __builtin_cpu_supports("avx2") ? 1 : 0;
+    __atomic_store_n(&have_avx2_cache, have_avx2, __ATOMIC_RELAXED);
+  }
+  if (have_avx2) {
+    hchacha_x8_avx2(hash, key, nonce, rounds);
+    return;
+  }
+#endif
+  hchacha_x8_generic(hash, key, nonce, rounds);
+}
+
+void slowcrypt_kchacha_many(uint8_t out[][32],
+                            uint8_t const protocol_constant[16],
+                            uint8_t const* const data[],
+                            unsigned const data_len[],
+                            unsigned n,
+                            int rounds)
+{
+  uint8_t state[8][32], key[8][32], hash[8][32], nonce[8][16];
+  unsigned base, l, i, c, lanes, nchunks[8], max_chunks, chunk_len;
+  uint8_t const* chunk;
+
+  for (l = 0; l < 8; l++)
+    for (i = 0; i < 16; i++)
+      nonce[l][i] = protocol_constant[i];
+
+  for (base = 0; base < n; base += 8) {
+    lanes = n - base;
+    if (lanes > 8)
+      lanes = 8;
+
+    /* full chunks, plus the padded last chunk */
+    max_chunks = 0;
+    for (l = 0; l < 8; l++) {
+      nchunks[l] = l < lanes ? data_len[base + l] / 32 + 1 : 0;
+      if (nchunks[l] > max_chunks)
+        max_chunks = nchunks[l];
+      for (i = 0; i < 32; i++)
+        state[l][i] = 0;
+    }
+
+    /* lanes with shorter messages just idle until the longest is done */
+    for (c = 0; c < max_chunks; c++) {
+      for (l = 0; l < 8; l++) {
+        if (c >= nchunks[l]) {
+          for (i = 0; i < 32; i++)
+            key[l][i] = 0;
+          continue;
+        }
+
+        chunk = &data[base + l][c * 32];
+        chunk_len = data_len[base + l] - c * 32;
+        if (chunk_len >= 32) {
+          for (i = 0; i < 32; i++)
+            key[l][i] = chunk[i] ^ state[l][i];
+        } else {
+          /* ANSI X9.23 padding, see slowcrypt_kchacha_final() */
+          for (i = 0; i < chunk_len; i++)
+            key[l][i] = chunk[i];
+          for (; i < 31; i++)
+            key[l][i] = 0;
+          key[l][31] = 32 - chunk_len;
+          for (i = 0; i < 32; i++)
+            key[l][i] ^= state[l][i];
+        }
+      }
+
+      slowcrypt_hchacha_x8(hash, (uint8_t const(*)[32])key,
+                           (uint8_t const(*)[16])nonce, rounds);
+
+      for (l = 0; l < 8; l++)
+        if (c < nchunks[l])
+          for (i = 0; i < 32; i++)
+            state[l][i] = hash[l][i];
+    }
+
+    for (l = 0; l < lanes; l++)
+      for (i = 0; i < 32; i++)
+        out[base + l][i] = state[l][i];
+  }
+
+  for (l = 0; l < 8; l++) {
+    for (i = 0; i < 32; i++) {
+      ((volatile uint8_t*)state[l])[i] = 0;
+      ((volatile uint8_t*)key[l])[i] = 0;
+      ((volatile uint8_t*)hash[l])[i] = 0;
+    }
+  }
+}
@@ -1,3 +1,5 @@
+#include <errno.h>
+#include <limits.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
@@ -114,37 +116,14 @@ static unsigned long file_read_chunk(FILE* file,
   return n;
 }
 
-static void* file_read_all(FILE* file, unsigned long* lenout)
+/* feeds the whole file into the KChaCha context, using constant memory */
+static void file_kchacha_update(FILE* file, slowcrypt_kchacha_ctx* ctx)
 {
-  void* all = 0;
-  void* allnew;
-  unsigned long all_len = 0;
-  void* buf = malloc(8 * 1024);
+  static uint8_t buf[8 * 1024];
   unsigned long clen;
-  if (!buf) {
-    fprintf(stderr, "malloc fail (8KiB)\n");
-    exit(1);
-  }
-
-  while (!feof(file)) {
-    clen = file_read_chunk(file, buf, 8 * 1024);
-    if (!clen)
-      break;
-    allnew = realloc(all, all_len + clen);
-    if (!allnew) {
-      free(all);
-      fprintf(stderr, "malloc fail (%lu B)\n", all_len + clen);
-      exit(1);
-    }
-    all = allnew;
-    memcpy(all + all_len, buf, clen);
-    all_len += clen;
-  }
 
-  free(buf);
-
-  *lenout = all_len;
-  return all;
+  while ((clen = file_read_chunk(file, buf, sizeof buf)))
+    slowcrypt_kchacha_update(ctx, buf, clen);
 }
 
 static void parse_rng_args(unsigned long* oLimit,
@@ -195,8 +174,7 @@ static void run_kchacha(char** args)
   int nrounds = 20;
   int npos = 0;
   int i;
-  uint8_t* input;
-  unsigned long len;
+  slowcrypt_kchacha_ctx ctx;
 
   for (; *args; args++) {
     if (anyeq(*args, "-h", "-help", "--help")) {
@@ -221,8 +199,9 @@ static void run_kchacha(char** args)
   parse_hex2buf(protocol_constant, 16, "protocol-constant",
                 protocol_constant_hex);
 
-  input = file_read_all(stdin, &len);
-  slowcrypt_kchacha(hash, protocol_constant, input, len, nrounds);
+  slowcrypt_kchacha_init(&ctx, protocol_constant, nrounds);
+  file_kchacha_update(stdin, &ctx);
+  slowcrypt_kchacha_final(&ctx, hash);
 
   for (i = 0; i < 32; i++)
     printf("%02x", hash[i]);
@@ -233,23 +212,36 @@ static void run_balloon_kchacha(char** args)
 {
   static char const help[] =
       "balloon-kchacha [--chacha-rounds N] [--space Bytes] [--balloon-rounds "
-      "N] <protocol-constant>\n"
+      "N] [--lanes N] <protocol-constant>\n"
+      "balloon-kchacha [--chacha-rounds N] --calibrate <ms> [--max-mem "
+      "Bytes]\n"
       "\n"
       "Run the balloon-hash function using KChaCha as inner function, with "
       "system entropy as salt\n"
       "\n"
       "Defaults to 20 ChaCha rounds, 1 Balloon round, and 256MiB space.\n"
       "\n"
+      "With --lanes, runs the parallel (Balloon-M style) variant, with N "
+      "lanes (at most 1024) that each use the given space.\n"
+      "\n"
+      "With --calibrate, benchmarks this machine and reports the strongest "
+      "parameters where one hash takes at most the given time, and uses at "
+      "most --max-mem bytes (defaults to --space)\n"
+      "\n"
       "Protocol constant is a hex value, that should be unique to each "
       "aplication,\n"
       " and NEVER be zero!\n";
   uint8_t hash[32], salt[32], protocol_constant[16];
   char const* protocol_constant_hex;
   int chacha_rounds = 20, balloon_rounds = 1, space = 256 * 1024 * 1024;
+  int lanes = 0;
+  unsigned calibrate_ms = 0;
+  unsigned long max_mem = 0, num;
+  char* end;
+  slowcrypt_balloon_kchacha_params params;
   int npos = 0;
   int i;
-  uint8_t* input;
-  unsigned long len;
+  slowcrypt_kchacha_ctx pw;
 
   for (; *args; args++) {
     if (anyeq(*args, "-h", "-help", "--help")) {
@@ -264,6 +256,22 @@ static void run_balloon_kchacha(char** args)
     } else if (anyeq(*args, "-s", "-space", "--space") && args[1]) {
       args++;
       space = atoi(*args);
+    } else if (anyeq(*args, "-l", "-lanes", "--lanes") && args[1]) {
+      args++;
+      lanes = atoi(*args);
+    } else if (anyeq(*args, "-calibrate", "--calibrate") && args[1]) {
+      args++;
+      errno = 0;
+      num = strtoul(*args, &end, 10);
+      if (errno || end == *args || *end || **args == '-' || num > UINT_MAX) {
+        fprintf(stderr, "--calibrate has to be between 0 and %u ms\n",
+                UINT_MAX);
+        exit(1);
+      }
+      calibrate_ms = (unsigned)num;
+    } else if (anyeq(*args, "-max-mem", "--max-mem") && args[1]) {
+      args++;
+      sscanf(*args, "%lu", &max_mem);
     } else if (npos == 0 && ++npos) {
       protocol_constant_hex = *args;
     } else {
@@ -272,6 +280,35 @@ static void run_balloon_kchacha(char** args)
     }
   }
 
+  /* every lane is a thread with its own buffer */
+  if (lanes < 0 || lanes > 1024) {
+    fprintf(stderr, "--lanes has to be between 0 and 1024\n");
+    exit(1);
+  }
+
+  if (calibrate_ms) {
+    if (!max_mem)
+      max_mem = space;
+    switch (slowcrypt_balloon_kchacha_calibrate(&params, calibrate_ms, max_mem,
+                                                chacha_rounds)) {
+      case 0:
+        break;
+      case 1:
+        fprintf(stderr, "oom\n");
+        exit(1);
+      default:
+        fprintf(stderr, "Time or memory budget too small\n");
+        exit(1);
+    }
+
+    printf("Space: %u\n", params.buffer_size);
+    printf("Balloon rounds: %u\n", params.balloon_rounds);
+    printf("ChaCha rounds: %u\n", params.kchacha_rounds);
+    printf("Measured: %.1f ms/hash (%.2f hashes/s per core)\n",
+           params.ms_per_hash, params.hashes_per_sec);
+    return;
+  }
+
   if (npos < 1) {
     fprintf(stderr, "Missing arguments!\n");
     exit(1);
@@ -280,7 +317,8 @@ static void run_balloon_kchacha(char** args)
   parse_hex2buf(protocol_constant, 16, "protocol-constant",
                 protocol_constant_hex);
 
-  input = file_read_all(stdin, &len);
+  slowcrypt_balloon_kchacha_init(&pw, protocol_constant, chacha_rounds);
+  file_kchacha_update(stdin, &pw);
 
   if (slowcrypt_systemrand(salt, sizeof salt,
                            SLOWCRYPT_SYSTEMRAND__BAIL_IF_INSECURE)) {
@@ -288,9 +326,10 @@ static void run_balloon_kchacha(char** args)
     exit(1);
   }
 
-  if (slowcrypt_balloon_kchacha(hash, protocol_constant, input, len, salt,
-                                sizeof salt, space, balloon_rounds,
-                                chacha_rounds)) {
+  if (lanes ? slowcrypt_balloon_kchacha_parallel_final(
+                  hash, &pw, salt, sizeof salt, space, balloon_rounds, lanes)
+            : slowcrypt_balloon_kchacha_final(hash, &pw, salt, sizeof salt,
+                                              space, balloon_rounds)) {
     fprintf(stderr, "oom\n");
     exit(1);
   }
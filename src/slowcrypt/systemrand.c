@@ -3,7 +3,11 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-#ifdef unix
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#define HAVE_UNIX
+#endif
+
+#ifdef HAVE_UNIX
 #include <sys/param.h>
 
 #if defined(__GLIBC__) && \
@@ -22,8 +26,42 @@
 #endif
 
 #include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
 #include <unistd.h>
 
+/* older libc (or musl) on a kernel that has it: call it directly */
+#if !defined(HAVE_SYS_RANDOM) && defined(__linux__)
+#include <sys/syscall.h>
+#ifdef SYS_getrandom
+#define HAVE_SYS_RANDOM
+#define GRND_NONBLOCK 0x0001
+static long getrandom(void* buffer, size_t length, unsigned int flags)
+{
+  return syscall(SYS_getrandom, buffer, length, flags);
+}
+#endif
+#endif
+
+#ifndef O_CLOEXEC
+#define O_CLOEXEC 0
+#endif
+
+/* vDSO getrandom (Linux 6.11+), which glibc only uses itself since 2.41 */
+#if defined(__linux__) && defined(HAVE_SYS_RANDOM) && \
+    (defined(__GNUC__) || defined(__clang__)) &&     \
+    !defined(SLOWCRYPT_SYSTEMRAND_NO_VDSO)
+#include <elf.h>
+#include <link.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <string.h>
+#include <sys/auxv.h>
+#include <sys/mman.h>
+#define HAVE_VGETRANDOM
+#endif
+
 #endif
 
 #ifdef _WIN32
@@ -35,14 +73,370 @@ static HMODULE slowcrypt_systemrand__hmod_advapi = 0;
 static HMODULE slowcrypt_systemrand__hmod_bcrypt = 0;
 #endif
 
-static int chunk256(void* buffer,
-                    unsigned long length,
-                    slowcrypt_systemrand_flags flags)
+#ifdef HAVE_SYS_RANDOM
+/* 0 on success, 1 if the next source should be tried */
+static int from_getrandom(unsigned char* buffer,
+                          unsigned long length,
+                          slowcrypt_systemrand_flags flags)
+{
+  unsigned int grnd = 0;
+  long n;
+
+  /* without the flag, blocks until the pool is initialized, like /dev/random */
+  if (flags & SLOWCRYPT_SYSTEMRAND__INSECURE_NON_BLOCKING)
+    grnd = GRND_NONBLOCK;
+
+  /* large requests can return less, and signals can interrupt it */
+  while (length > 0) {
+    n = getrandom(buffer, length, grnd);
+    if (n < 0) {
+      if (errno == EINTR)
+        continue;
+      return 1;
+    }
+    buffer += n;
+    length -= (unsigned long)n;
+  }
+  return 0;
+}
+#endif
+
+#ifdef HAVE_VGETRANDOM
+/* returned by the vDSO function, when called with opaque_len = ~0 */
+struct vgetrandom_params
+{
+  uint32_t size_of_opaque_state;
+  uint32_t mmap_prot;
+  uint32_t mmap_flags;
+  uint32_t reserved[13];
+};
+
+typedef long (*vgetrandom_fn)(void* buffer,
+                              size_t length,
+                              unsigned int flags,
+                              void* opaque_state,
+                              size_t opaque_len);
+
+static pthread_once_t vgetrandom__once = PTHREAD_ONCE_INIT;
+static vgetrandom_fn vgetrandom__fn = 0;
+static struct vgetrandom_params vgetrandom__params;
+static pthread_key_t vgetrandom__key;
+
+/* opaque states of exited threads, and not yet used ones */
+static pthread_mutex_t vgetrandom__lock = PTHREAD_MUTEX_INITIALIZER;
+static void** vgetrandom__free = 0;
+static size_t vgetrandom__nfree = 0;
+static size_t vgetrandom__capfree = 0;
+
+/* the state of this thread, allocated on first use */
+static __thread void* vgetrandom__state = 0;
+
+static void* vdso_symbol(char const* name)
+{
+  uintptr_t base = (uintptr_t)getauxval(AT_SYSINFO_EHDR);
+  ElfW(Ehdr) const* ehdr = (ElfW(Ehdr) const*)base;
+  ElfW(Phdr) const* phdr;
+  ElfW(Dyn) const* dyn = 0;
+  ElfW(Sym) const* sym = 0;
+  char const* strtab = 0;
+  uint32_t const* hash = 0;
+  uintptr_t load_offset = 0;
+  int have_load = 0;
+  size_t i;
+
+  if (!base || memcmp(ehdr->e_ident, ELFMAG, SELFMAG))
+    return 0;
+
+  phdr = (ElfW(Phdr) const*)(base + ehdr->e_phoff);
+  for (i = 0; i < ehdr->e_phnum; i++) {
+    if (phdr[i].p_type == PT_LOAD && !have_load) {
+      load_offset = base + phdr[i].p_offset - phdr[i].p_vaddr;
+      have_load = 1;
+    } else if (phdr[i].p_type == PT_DYNAMIC) {
+      dyn = (ElfW(Dyn) const*)(base + phdr[i].p_offset);
+    }
+  }
+  if (!have_load || !dyn)
+    return 0;
+
+  for (; dyn->d_tag != DT_NULL; dyn++) {
+    if (dyn->d_tag == DT_STRTAB)
+      strtab = (char const*)(load_offset + dyn->d_un.d_ptr);
+    else if (dyn->d_tag == DT_SYMTAB)
+      sym = (ElfW(Sym) const*)(load_offset + dyn->d_un.d_ptr);
+    else if (dyn->d_tag == DT_HASH)
+      hash = (uint32_t const*)(load_offset + dyn->d_un.d_ptr);
+  }
+  if (!strtab || !sym || !hash)
+    return 0;
+
+  /* hash[1] is the number of symbols */
+  for (i = 0; i < hash[1]; i++) {
+    if (ELF64_ST_TYPE(sym[i].st_info) != STT_FUNC ||
+        sym[i].st_shndx == SHN_UNDEF)
+      continue;
+    if (!strcmp(strtab + sym[i].st_name, name))
+      return (void*)(load_offset + sym[i].st_value);
+  }
+  return 0;
+}
+
+static void vgetrandom_put_state(void* state)
+{
+  void** grown;
+
+  pthread_mutex_lock(&vgetrandom__lock);
+  if (vgetrandom__nfree == vgetrandom__capfree) {
+    grown = realloc(vgetrandom__free,
+                    sizeof(void*) * (vgetrandom__capfree * 2 + 8));
+    if (!grown) {
+      /* leaks the state, which is not worth failing over */
+      pthread_mutex_unlock(&vgetrandom__lock);
+      return;
+    }
+    vgetrandom__free = grown;
+    vgetrandom__capfree = vgetrandom__capfree * 2 + 8;
+  }
+  vgetrandom__free[vgetrandom__nfree++] = state;
+  pthread_mutex_unlock(&vgetrandom__lock);
+}
+
+static void* vgetrandom_take_state(void)
+{
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+  size_t size = vgetrandom__params.size_of_opaque_state;
+  size_t i, per_page = page / size;
+  unsigned char* states;
+  void* state = 0;
+
+  pthread_mutex_lock(&vgetrandom__lock);
+  if (vgetrandom__nfree)
+    state = vgetrandom__free[--vgetrandom__nfree];
+  pthread_mutex_unlock(&vgetrandom__lock);
+  if (state)
+    return state;
+
+  /* a state must not cross a page boundary: fill one page at a time */
+  states = mmap(0, page, (int)vgetrandom__params.mmap_prot,
+                (int)vgetrandom__params.mmap_flags, -1, 0);
+  if (states == MAP_FAILED)
+    return 0;
+  for (i = 1; i < per_page; i++)
+    vgetrandom_put_state(&states[i * size]);
+  return states;
+}
+
+static void vgetrandom_thread_exit(void* state)
+{
+  /* other destructors of this thread may still use systemrand: they have to
+   * take a new state, because this one can now be taken by another thread */
+  vgetrandom__state = 0;
+  vgetrandom_put_state(state);
+}
+
+static void vgetrandom_init(void)
+{
+  vgetrandom_fn fn;
+  size_t page = (size_t)sysconf(_SC_PAGESIZE);
+
+  /* x86 name, and the name on arm64, powerpc, s390, ... */
+  fn = (vgetrandom_fn)vdso_symbol("__vdso_getrandom");
+  if (!fn)
+    fn = (vgetrandom_fn)vdso_symbol("__kernel_getrandom");
+  if (!fn)
+    return;
+
+  if (fn(0, 0, 0, &vgetrandom__params, ~(size_t)0) != 0)
+    return;
+  if (!vgetrandom__params.size_of_opaque_state ||
+      vgetrandom__params.size_of_opaque_state > page)
+    return;
+  if (pthread_key_create(&vgetrandom__key, vgetrandom_thread_exit))
+    return;
+
+  vgetrandom__fn = fn;
+}
+
+/* 0 on success, 1 if the next source should be tried */
+static int from_vgetrandom(unsigned char* buffer,
+                           unsigned long length,
+                           slowcrypt_systemrand_flags flags)
+{
+  unsigned int grnd = 0;
+  long n;
+
+  pthread_once(&vgetrandom__once, vgetrandom_init);
+  if (!vgetrandom__fn)
+    return 1;
+
+  if (!vgetrandom__state) {
+    vgetrandom__state = vgetrandom_take_state();
+    if (!vgetrandom__state)
+      return 1;
+    pthread_setspecific(vgetrandom__key, vgetrandom__state);
+  }
+
+  if (flags & SLOWCRYPT_SYSTEMRAND__INSECURE_NON_BLOCKING)
+    grnd = GRND_NONBLOCK;
+
+  /* same semantics as the syscall, but returns -errno */
+  while (length > 0) {
+    n = vgetrandom__fn(buffer, length, grnd, vgetrandom__state,
+                       vgetrandom__params.size_of_opaque_state);
+    if (n == -EINTR)
+      continue;
+    if (n < 0)
+      return 1;
+    buffer += n;
+    length -= (unsigned long)n;
+  }
+  return 0;
+}
+#endif
+
+#if defined(HAVE_GETENTROPY) && !defined(HAVE_SYS_RANDOM)
+static int from_getentropy(unsigned char* buffer, unsigned long length)
+{
+  unsigned long n;
+
+  /* limited to 256 bytes per call */
+  while (length > 0) {
+    n = length > 256 ? 256 : length;
+    if (getentropy(buffer, n))
+      return 1;
+    buffer += n;
+    length -= n;
+  }
+  return 0;
+}
+#endif
+
+#ifdef HAVE_UNIX
+/* opened on first use, and kept open */
+static int slowcrypt_systemrand__fd[2] = {-1, -1};
+/* st_rdev of the opened devices, to detect reused fd numbers */
+static dev_t slowcrypt_systemrand__rdev[2];
+
+/* replaces the cached fd with `desired`, if it still is `*expected` */
+static int swap_device(int nonblocking, int* expected, int desired)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_compare_exchange_n(&slowcrypt_systemrand__fd[nonblocking],
+                                     expected, desired, 0, __ATOMIC_ACQ_REL,
+                                     __ATOMIC_ACQUIRE);
+#else
+  if (slowcrypt_systemrand__fd[nonblocking] != *expected) {
+    *expected = slowcrypt_systemrand__fd[nonblocking];
+    return 0;
+  }
+  slowcrypt_systemrand__fd[nonblocking] = desired;
+  return 1;
+#endif
+}
+
+static int load_device(int nonblocking)
+{
+#if defined(__GNUC__) || defined(__clang__)
+  return __atomic_load_n(&slowcrypt_systemrand__fd[nonblocking],
+                         __ATOMIC_ACQUIRE);
+#else
+  return slowcrypt_systemrand__fd[nonblocking];
+#endif
+}
+
+/* the application could have closed the fd, and opened something else,
+ * that got the same number (daemonizing, for example) */
+static int is_random_device(int nonblocking, int fd)
+{
+  struct stat st;
+  dev_t rdev;
+
+#if defined(__GNUC__) || defined(__clang__)
+  rdev = __atomic_load_n(&slowcrypt_systemrand__rdev[nonblocking],
+                         __ATOMIC_RELAXED);
+#else
+  rdev = slowcrypt_systemrand__rdev[nonblocking];
+#endif
+  return fstat(fd, &st) == 0 && S_ISCHR(st.st_mode) && st.st_rdev == rdev;
+}
+
+static int random_device(int nonblocking)
+{
+  int fd = load_device(nonblocking);
+  int expected = -1;
+  struct stat st;
+
+  if (fd >= 0) {
+    if (is_random_device(nonblocking, fd))
+      return fd;
+    /* not ours anymore, so don't close it */
+    swap_device(nonblocking, &fd, -1);
+  }
+
+  do {
+    fd = open(nonblocking ? "/dev/urandom" : "/dev/random",
+              O_RDONLY | O_CLOEXEC);
+  } while (fd < 0 && errno == EINTR);
+  if (fd < 0)
+    return -1;
+  if (fstat(fd, &st) != 0 || !S_ISCHR(st.st_mode)) {
+    close(fd);
+    return -1;
+  }
+
+  /* always the same device for the same path, so racing stores agree.
+   * published together with the fd by swap_device() */
+#if defined(__GNUC__) || defined(__clang__)
+  __atomic_store_n(&slowcrypt_systemrand__rdev[nonblocking], st.st_rdev,
+                   __ATOMIC_RELAXED);
+#else
+  slowcrypt_systemrand__rdev[nonblocking] = st.st_rdev;
+#endif
+
+  /* another thread was faster: use theirs */
+  if (!swap_device(nonblocking, &expected, fd)) {
+    close(fd);
+    fd = expected;
+  }
+  return fd;
+}
+
+static int from_device(unsigned char* buffer,
+                       unsigned long length,
+                       slowcrypt_systemrand_flags flags)
+{
+  int nonblocking =
+      (flags & SLOWCRYPT_SYSTEMRAND__INSECURE_NON_BLOCKING) ? 1 : 0;
+  int fd = random_device(nonblocking);
+  long n;
+
+  if (fd < 0)
+    return 1;
+
+  while (length > 0) {
+    n = read(fd, buffer, length);
+    if (n < 0 && errno == EINTR)
+      continue;
+    if (n < 0 && errno == EBADF) {
+      /* the application closed it (daemonizing, for example): open it again */
+      swap_device(nonblocking, &fd, -1);
+      return from_device(buffer, length, flags);
+    }
+    if (n <= 0)
+      return 1;
+    buffer += n;
+    length -= (unsigned long)n;
+  }
+  return 0;
+}
+#endif
+
+static int fill(void* buffer,
+                unsigned long length,
+                slowcrypt_systemrand_flags flags)
 {
   unsigned long i, j;
   unsigned char u8;
-  char const* fpath;
-  FILE* fp;
 #ifdef _WIN32
   FARPROC proc;
   NTSTATUS status;
@@ -50,27 +444,25 @@ static int chunk256(void* buffer,
   HCRYPTPROV hProv;
 #endif
 
-#ifdef HAVE_GETENTROPY
-  if (!getentropy(buffer, length))
+  /* a source that fails part way through is overwritten by the next one */
+#ifdef HAVE_VGETRANDOM
+  if (!from_vgetrandom(buffer, length, flags))
     return 0;
 #endif
 
 #ifdef HAVE_SYS_RANDOM
-  if (256 == getrandom(buffer, lenght))
+  if (!from_getrandom(buffer, length, flags))
     return 0;
 #endif
 
-#ifndef _WIN32
-  fpath = (flags & SLOWCRYPT_SYSTEMRAND__INSECURE_NON_BLOCKING) ? "/dev/urandom"
-                                                                : "/dev/random";
+#if defined(HAVE_GETENTROPY) && !defined(HAVE_SYS_RANDOM)
+  if (!from_getentropy(buffer, length))
+    return 0;
+#endif
 
-  fp = fopen(fpath, "rb");
-  if (fp) {
-    i = fread(buffer, 1, length, fp);
-    fclose(fp);
-    if (i == length)
-      return 0;
-  }
+#ifdef HAVE_UNIX
+  if (!from_device(buffer, length, flags))
+    return 0;
 #endif
 
 #ifdef _WIN32
@@ -148,25 +540,83 @@ int slowcrypt_systemrand(void* buffer,
                          unsigned long length,
                          slowcrypt_systemrand_flags flags)
 {
-  unsigned int i, j;
-  int rc = 0;
-
-  /* many random sources have a limit of 256 bytes */
-  for (i = 0; i < length; i += 256) {
-    j = length - i;
-    if (j > 256)
-      j = 256;
-    if ((rc = chunk256(buffer, length, flags))) {
-      break;
-    }
-  }
+  int rc = fill(buffer, length, flags);
 
 #ifdef _WIN32
   if (slowcrypt_systemrand__hmod_advapi)
     FreeLibrary(slowcrypt_systemrand__hmod_advapi);
   if (slowcrypt_systemrand__hmod_bcrypt)
     FreeLibrary(slowcrypt_systemrand__hmod_bcrypt);
+  slowcrypt_systemrand__hmod_advapi = 0;
+  slowcrypt_systemrand__hmod_bcrypt = 0;
 #endif
 
   return rc;
 }
+
+#ifdef HAVE_UNIX
+/* once initialized, the pool stays initialized */
+static volatile int slowcrypt_systemrand__ready = 0;
+#endif
+
+slowlibs_io_status slowcrypt_systemrand_ready(void)
+{
+#ifdef HAVE_UNIX
+  struct pollfd p;
+  int fd, rc;
+#ifdef HAVE_SYS_RANDOM
+  unsigned char probe;
+  long n;
+#endif
+
+  if (slowcrypt_systemrand__ready)
+    return SLOWLIBS_IO_OK;
+
+#ifdef HAVE_SYS_RANDOM
+  do {
+    n = getrandom(&probe, 1, GRND_NONBLOCK);
+  } while (n < 0 && errno == EINTR);
+  if (n == 1)
+    goto ready;
+  if (n < 0 && errno == EAGAIN)
+    return SLOWLIBS_IO_WOULD_BLOCK;
+#endif
+
+  /* no getrandom: /dev/random is readable once the pool is initialized */
+  fd = random_device(0);
+  if (fd < 0)
+    goto ready; /* nothing to wait on */
+  p.fd = fd;
+  p.events = POLLIN;
+  p.revents = 0;
+  do {
+    rc = poll(&p, 1, 0);
+  } while (rc < 0 && errno == EINTR);
+  if (rc == 0)
+    return SLOWLIBS_IO_WOULD_BLOCK;
+
+ready:
+  slowcrypt_systemrand__ready = 1;
+#endif
+  return SLOWLIBS_IO_OK;
+}
+
+slowlibs_io_status slowcrypt_systemrand_try(void* buffer, unsigned long length)
+{
+  slowlibs_io_status status = slowcrypt_systemrand_ready();
+  if (status != SLOWLIBS_IO_OK)
+    return status;
+  if (slowcrypt_systemrand(buffer, length,
+                           SLOWCRYPT_SYSTEMRAND__BAIL_IF_INSECURE))
+    return SLOWLIBS_IO_EXTERNAL_ERROR;
+  return SLOWLIBS_IO_OK;
+}
+
+int slowcrypt_systemrand_poll_fd(void)
+{
+#ifdef HAVE_UNIX
+  return random_device(0);
+#else
+  return -1;
+#endif
+}
@@ -0,0 +1,27 @@
+
+#include "slowlibs/chacha20.h"
+
+int main(int argc, char** argv)
+{
+  slowcrypt_balloon_kchacha_params params;
+
+  (void)argc;
+  (void)argv;
+
+  /* results depend on the machine, so only check that they fit the budget */
+  if (slowcrypt_balloon_kchacha_calibrate(&params, 2000, 1024 * 1024, 8))
+    return 1;
+
+  if (params.buffer_size > 1024 * 1024 || params.buffer_size % 32)
+    return 1;
+  if (params.balloon_rounds < 1 || params.kchacha_rounds != 8)
+    return 1;
+  if (params.ms_per_hash > 2000 || params.hashes_per_sec <= 0)
+    return 1;
+
+  /* nothing fits in 64 bytes */
+  if (slowcrypt_balloon_kchacha_calibrate(&params, 2000, 64, 8) != 2)
+    return 1;
+
+  return 0;
+}
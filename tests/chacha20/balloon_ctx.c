@@ -0,0 +1,68 @@
+
+#include "slowlibs/chacha20.h"
+
+static char const data[] = "SeriousPassword";
+
+static uint8_t const protocol_constant[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                            0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                            0x0d, 0x0e, 0x0f, 0xfa};
+
+static uint8_t const expected[] = {
+    0x34, 0xdf, 0x57, 0xcd, 0xdc, 0x2e, 0x5f, 0x14, 0x7e, 0xe7, 0xd1,
+    0x86, 0xaf, 0x78, 0x8a, 0xe9, 0x9d, 0x98, 0xee, 0x1e, 0x24, 0xc4,
+    0xb4, 0x45, 0xc4, 0xb7, 0xc7, 0x35, 0xe0, 0xa3, 0x14, 0xaf};
+
+static uint8_t const salt[] = {
+    0xda, 0x0e, 0xb9, 0xe9, 0x8b, 0x48, 0x2a, 0x18,
+    0x2f, 0xe3, 0xdf, 0xd3, 0x74, 0x39, 0xa9, 0xdd,
+    /* only used by the longer salt */
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08,
+    0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10,
+    0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18,
+};
+
+static int hash_eq(uint8_t const a[32], uint8_t const b[32])
+{
+  int i;
+  for (i = 0; i < 32; i++)
+    if (a[i] != b[i])
+      return 0;
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  slowcrypt_balloon_kchacha_ctx ctx;
+  uint8_t hash[32], ref[32];
+  int run;
+
+  (void)argc;
+  (void)argv;
+
+  // NOTE: These parameters are too low for actual passwords!
+  if (slowcrypt_balloon_kchacha_ctx_init(&ctx, protocol_constant,
+                                         4 * 1024 * 1024, 1, 8,
+                                         SLOWCRYPT_BALLOON__HUGE_PAGES))
+    return 1;
+
+  /* reusing the workspace must not change the result */
+  for (run = 0; run < 2; run++) {
+    if (slowcrypt_balloon_kchacha_ctx_salt(&ctx, salt, 16))
+      return 1;
+    slowcrypt_balloon_kchacha_ctx_run(&ctx, hash, (void*)data,
+                                      sizeof(data) - 1);
+    if (!hash_eq(hash, expected))
+      return 1;
+
+    if (slowcrypt_balloon_kchacha_ctx_salt(&ctx, salt, sizeof salt))
+      return 1;
+    slowcrypt_balloon_kchacha_ctx_run(&ctx, hash, (void*)data, 3);
+    slowcrypt_balloon_kchacha(ref, protocol_constant, (void*)data, 3, salt,
+                              sizeof salt, 4 * 1024 * 1024, 1, 8);
+    if (!hash_eq(hash, ref))
+      return 1;
+  }
+
+  slowcrypt_balloon_kchacha_ctx_deinit(&ctx);
+  return 0;
+}
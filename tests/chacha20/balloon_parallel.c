@@ -0,0 +1,85 @@
+
+#include "slowlibs/chacha20.h"
+
+static char const data[] = "SeriousPassword";
+
+static uint8_t const protocol_constant[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                            0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                            0x0d, 0x0e, 0x0f, 0xfa};
+
+static uint8_t const expected[] = {
+    0x9a, 0xad, 0xd1, 0x34, 0x86, 0xb9, 0x09, 0xfb, 0xdf, 0x35, 0x1d,
+    0xf2, 0xc5, 0xbe, 0x7e, 0x5b, 0x86, 0x75, 0x30, 0x92, 0x50, 0x85,
+    0xaa, 0x16, 0xa5, 0x6d, 0x0f, 0x6e, 0xcf, 0xf4, 0xb3, 0xb2};
+
+static uint8_t const salt[] = {
+    0xda, 0x0e, 0xb9, 0xe9, 0x8b, 0x48, 0x2a, 0x18,
+    0x2f, 0xe3, 0xdf, 0xd3, 0x74, 0x39, 0xa9, 0xdd,
+};
+
+/* lane l is plain Balloon-KChaCha with salt || u32(l) */
+static void reference(uint8_t out[32], unsigned lanes)
+{
+  uint8_t lane_salt[16 + 4], lane_out[32], acc[32];
+  uint8_t combine[4 + sizeof(data) - 1 + 16 + 4 + 32] = {0};
+  unsigned l, i;
+
+  for (i = 0; i < 32; i++)
+    acc[i] = 0;
+
+  for (l = 1; l <= lanes; l++) {
+    for (i = 0; i < 16; i++)
+      lane_salt[i] = salt[i];
+    lane_salt[16] = l;
+    lane_salt[17] = 0;
+    lane_salt[18] = 0;
+    lane_salt[19] = 0;
+    slowcrypt_balloon_kchacha(lane_out, protocol_constant, (void*)data,
+                              sizeof(data) - 1, lane_salt, 20, 64 * 1024, 1, 8);
+    for (i = 0; i < 32; i++)
+      acc[i] ^= lane_out[i];
+  }
+
+  for (i = 0; i < sizeof(data) - 1; i++)
+    combine[4 + i] = data[i];
+  for (i = 0; i < 16; i++)
+    combine[4 + sizeof(data) - 1 + i] = salt[i];
+  for (i = 0; i < 32; i++)
+    combine[4 + sizeof(data) - 1 + 16 + 4 + i] = acc[i];
+  slowcrypt_kchacha(out, protocol_constant, combine, sizeof combine, 8);
+}
+
+int main(int argc, char** argv)
+{
+  uint8_t hash[32], ref[32];
+  unsigned lanes;
+  int i;
+
+  (void)argc;
+  (void)argv;
+
+  // NOTE: These parameters are too low for actual passwords!
+  if (slowcrypt_balloon_kchacha_parallel(hash, protocol_constant, (void*)data,
+                                         sizeof(data) - 1, salt, 16,
+                                         4 * 1024 * 1024, 1, 8, 4))
+    return 1;
+
+  for (i = 0; i < 32; i++) {
+    if (hash[i] != expected[i])
+      return 1;
+  }
+
+  for (lanes = 1; lanes <= 3; lanes++) {
+    reference(ref, lanes);
+    if (slowcrypt_balloon_kchacha_parallel(hash, protocol_constant,
+                                           (void*)data, sizeof(data) - 1, salt,
+                                           16, 64 * 1024, 1, 8, lanes))
+      return 1;
+    for (i = 0; i < 32; i++) {
+      if (hash[i] != ref[i])
+        return 1;
+    }
+  }
+
+  return 0;
+}
@@ -0,0 +1,75 @@
+
+#include "slowlibs/chacha20.h"
+
+static char const data[] =
+    "DoNotCurrently-Use-KChaCha-InSensitive-Applications!!NeedingMoreBytes-for-"
+    "getting-to-three-blocks.";
+
+static uint8_t const protocol_constant[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                            0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                            0x0d, 0x0e, 0x0f, 0xfa};
+
+static uint8_t const hchacha_key[] = {
+    0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a,
+    0x0b, 0x0c, 0x0d, 0x0e, 0x0f, 0x10, 0x11, 0x12, 0x13, 0x14, 0x15,
+    0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f,
+};
+
+static uint8_t const hchacha_nonce[] = {
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x4a,
+    0x00, 0x00, 0x00, 0x00, 0x10, 0x00, 0x2a, 0x3a,
+};
+
+static uint8_t const hchacha_expected[] = {
+    0xAD, 0xA7, 0xC7, 0xE3, 0x56, 0xC3, 0x58, 0xEC, 0x89, 0x85, 0xC0,
+    0xEA, 0x33, 0xBD, 0xC2, 0x38, 0x43, 0xE1, 0xE4, 0xAF, 0x79, 0xF1,
+    0x21, 0x62, 0xC4, 0xBD, 0xC5, 0x43, 0xF5, 0x51, 0xEF, 0x10,
+};
+
+#define NMSG 21
+
+int main(int argc, char** argv)
+{
+  uint8_t key[8][32], nonce[8][16], hash[8][32];
+  uint8_t out[NMSG][32], ref[32];
+  uint8_t const* msgs[NMSG];
+  unsigned lens[NMSG];
+  int i, l;
+
+  (void)argc;
+  (void)argv;
+
+  /* HChaCha20 test vector in every lane */
+  for (l = 0; l < 8; l++) {
+    for (i = 0; i < 32; i++)
+      key[l][i] = hchacha_key[i];
+    for (i = 0; i < 16; i++)
+      nonce[l][i] = hchacha_nonce[i];
+  }
+  slowcrypt_hchacha_x8(hash, (uint8_t const(*)[32])key,
+                       (uint8_t const(*)[16])nonce, 20);
+  for (l = 0; l < 8; l++)
+    for (i = 0; i < 32; i++)
+      if (hash[l][i] != hchacha_expected[i])
+        return 1;
+
+  /* ragged lengths, including empty and chunk-aligned messages */
+  for (l = 0; l < NMSG; l++) {
+    msgs[l] = (uint8_t const*)data + l;
+    lens[l] = (l * 13) % (sizeof(data) - 1 - NMSG);
+  }
+  lens[3] = 0;
+  lens[4] = 32;
+  lens[5] = 64;
+
+  slowcrypt_kchacha_many(out, protocol_constant, msgs, lens, NMSG, 12);
+
+  for (l = 0; l < NMSG; l++) {
+    slowcrypt_kchacha(ref, protocol_constant, msgs[l], lens[l], 12);
+    for (i = 0; i < 32; i++)
+      if (out[l][i] != ref[i])
+        return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+
+#include "slowlibs/chacha20.h"
+
+static char const data[] =
+    "DoNotCurrently-Use-KChaCha-InSensitive-Applications!!NeedingMoreBytes-for-"
+    "getting-to-three-blocks.";
+
+static uint8_t const protocol_constant[] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06,
+                                            0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c,
+                                            0x0d, 0x0e, 0x0f, 0xfa};
+
+static uint8_t const expected[] = {
+    0xda, 0x0e, 0xb9, 0xe9, 0x8b, 0x48, 0x2a, 0x18, 0x2f, 0xe3, 0xdf,
+    0xd3, 0x74, 0x39, 0xa9, 0xdd, 0xc4, 0xb9, 0xad, 0xbe, 0x3f, 0xab,
+    0xf8, 0x17, 0xea, 0xd2, 0x25, 0x0f, 0x6c, 0xa1, 0x60, 0x99,
+};
+
+static int hash_eq(uint8_t const a[32], uint8_t const b[32])
+{
+  int i;
+  for (i = 0; i < 32; i++)
+    if (a[i] != b[i])
+      return 0;
+  return 1;
+}
+
+int main(int argc, char** argv)
+{
+  slowcrypt_kchacha_ctx ctx;
+  uint8_t hash[32], oneshot[32];
+  unsigned len, step, pos, n;
+
+  (void)argc;
+  (void)argv;
+
+  /* test vector, absorbed in ragged pieces */
+  for (step = 1; step <= 40; step++) {
+    slowcrypt_kchacha_init(&ctx, protocol_constant, 20);
+    for (pos = 0; pos < sizeof(data) - 1; pos += n) {
+      n = sizeof(data) - 1 - pos;
+      if (n > step)
+        n = step;
+      slowcrypt_kchacha_update(&ctx, (uint8_t const*)data + pos, n);
+    }
+    slowcrypt_kchacha_final(&ctx, hash);
+
+    if (!hash_eq(hash, expected))
+      return 1;
+  }
+
+  /* padding edge cases around chunk boundaries */
+  for (len = 0; len < sizeof(data) - 1; len++) {
+    slowcrypt_kchacha(oneshot, protocol_constant, (void*)data, len, 8);
+
+    slowcrypt_kchacha_init(&ctx, protocol_constant, 8);
+    slowcrypt_kchacha_update(&ctx, (uint8_t const*)data, len / 2);
+    slowcrypt_kchacha_update(&ctx, 0, 0);
+    slowcrypt_kchacha_update(&ctx, (uint8_t const*)data + len / 2,
+                             len - len / 2);
+    slowcrypt_kchacha_final(&ctx, hash);
+
+    if (!hash_eq(hash, oneshot))
+      return 1;
+  }
+
+  return 0;
+}
@@ -0,0 +1,133 @@
+#include <stdio.h>
+#include <string.h>
+#include "slowlibs/fixed_bigint.h"
+
+static uint64_t rng = 0x13198a2e03707344;
+
+static void fill(slowlib_fbig_part* p, size_t np, size_t bits)
+{
+  size_t i;
+  for (i = 0; i < np * slowlib_fbig_part_sz; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    ((uint8_t*)p)[i] = i * 8 < bits ? (uint8_t)rng : 0;
+  }
+}
+
+static int failed = 0;
+
+static void check(char const* what,
+                  unsigned width,
+                  size_t idx,
+                  slowlib_fbig_part const* got,
+                  slowlib_fbig_part const* expected,
+                  size_t np)
+{
+  if (memcmp(got, expected, np * slowlib_fbig_part_sz)) {
+    printf("%s (%u bits, number %zu): mismatch\n", what, width, idx);
+    failed = 1;
+  }
+}
+
+#define NBATCHES 3
+#define NUMS (NBATCHES * SLOWLIBS_FBIG_BATCH_LANES)
+
+/* compares every number of the batches against the single-number macros */
+#define TEST_WIDTH(width)                                                   \
+  do {                                                                      \
+    slowlib_fbig_batch_var(width, ba, NBATCHES);                            \
+    slowlib_fbig_batch_var(width, bb, NBATCHES);                            \
+    slowlib_fbig_batch_var(width, bsum, NBATCHES);                          \
+    slowlib_fbig_part bprod[NBATCHES][2 * slowlib_fbig(width)]             \
+                           [SLOWLIBS_FBIG_BATCH_LANES];                     \
+    slowlib_fbig_var(width, m);                                             \
+    slowlib_fbig_var(width, a);                                             \
+    slowlib_fbig_var(width, b);                                             \
+    slowlib_fbig_var(width, got);                                           \
+    slowlib_fbig_var(width, expected);                                      \
+    slowlib_fbig_part prod[2 * slowlib_fbig(width)];                        \
+    slowlib_fbig_part gotprod[2 * slowlib_fbig(width)];                     \
+    slowlib_fbig_mont_ctx(width, mont);                                     \
+    size_t _i;                                                              \
+                                                                            \
+    for (_i = 0; _i < NUMS; _i++) {                                         \
+      fill(a, slowlib_fbig_np(a), (width));                                 \
+      fill(b, slowlib_fbig_np(b), (width));                                 \
+      slowlib_fbig_batch_set(ba, _i, a);                                    \
+      slowlib_fbig_batch_set(bb, _i, b);                                    \
+    }                                                                       \
+    slowlib_fbig_batch_add(bsum, ba, bb, NBATCHES);                         \
+    slowlib_fbig_batch_mul(bprod, ba, bb, NBATCHES);                        \
+    for (_i = 0; _i < NUMS; _i++) {                                         \
+      slowlib_fbig_batch_get(a, ba, _i);                                    \
+      slowlib_fbig_batch_get(b, bb, _i);                                    \
+      slowlib_fbig_add(expected, a, b);                                     \
+      slowlib_fbig_batch_get(got, bsum, _i);                                \
+      check("batch_add", (width), _i, got, expected, slowlib_fbig_np(got)); \
+      slowlib_fbig_mul(prod, a, b);                                         \
+      slowlib_fbig_batch_get(gotprod, bprod, _i);                           \
+      check("batch_mul", (width), _i, gotprod, prod,                        \
+            slowlib_fbig_np(prod));                                         \
+    }                                                                       \
+                                                                            \
+    fill(m, slowlib_fbig_np(m), (width));                                   \
+    m[0] |= 1;                                                              \
+    slowlib_fbig_mont_init(mont, m);                                        \
+    for (_i = 0; _i < NUMS; _i++) {                                         \
+      slowlib_fbig_batch_get(a, ba, _i);                                    \
+      slowlib_fbig_batch_get(b, bb, _i);                                    \
+      slowlib_fbig_umod(a, a, m);                                           \
+      slowlib_fbig_umod(b, b, m);                                           \
+      slowlib_fbig_batch_set(ba, _i, a);                                    \
+      slowlib_fbig_batch_set(bb, _i, b);                                    \
+    }                                                                       \
+    slowlib_fbig_batch_mont_mul(bsum, ba, bb, mont, NBATCHES);              \
+    for (_i = 0; _i < NUMS; _i++) {                                         \
+      slowlib_fbig_batch_get(a, ba, _i);                                    \
+      slowlib_fbig_batch_get(b, bb, _i);                                    \
+      slowlib_fbig_mont_mul(expected, a, b, mont);                          \
+      slowlib_fbig_batch_get(got, bsum, _i);                                \
+      check("batch_mont_mul", (width), _i, got, expected,                   \
+            slowlib_fbig_np(got));                                          \
+    }                                                                       \
+  } while (0)
+
+int main()
+{
+  TEST_WIDTH(64);
+  TEST_WIDTH(136);
+  TEST_WIDTH(256);
+  TEST_WIDTH(1024);
+
+  /* all ones: longest carry chains */
+  {
+    slowlib_fbig_batch_var(256, ba, 1);
+    slowlib_fbig_batch_var(256, bsum, 1);
+    slowlib_fbig_batch_var(512, bprod, 1);
+    slowlib_fbig_var(256, a);
+    slowlib_fbig_var(256, expected);
+    slowlib_fbig_var(256, got);
+    slowlib_fbig_var(512, prod);
+    slowlib_fbig_var(512, gotprod);
+    size_t i;
+
+    memset(a, 0xff, sizeof(a));
+    for (i = 0; i < SLOWLIBS_FBIG_BATCH_LANES; i++)
+      slowlib_fbig_batch_set(ba, i, a);
+    slowlib_fbig_batch_add(bsum, ba, ba, 1);
+    slowlib_fbig_batch_mul(bprod, ba, ba, 1);
+    slowlib_fbig_add(expected, a, a);
+    slowlib_fbig_mul(prod, a, a);
+    for (i = 0; i < SLOWLIBS_FBIG_BATCH_LANES; i++) {
+      slowlib_fbig_batch_get(got, bsum, i);
+      check("batch_add ones", 256, i, got, expected, slowlib_fbig_np(got));
+      slowlib_fbig_batch_get(gotprod, bprod, i);
+      check("batch_mul ones", 256, i, gotprod, prod, slowlib_fbig_np(prod));
+    }
+  }
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
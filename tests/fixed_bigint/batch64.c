@@ -0,0 +1,15 @@
+#ifdef __SIZEOF_INT128__
+
+/* no SIMD path for 64-bit parts: tests the one lane at a time fallback */
+#define SLOWLIBS_FBIG_PART_BITS 64
+#include "batch.c"
+
+#else
+
+/* 64-bit limbs not available: skip */
+int main()
+{
+  return 77;
+}
+
+#endif
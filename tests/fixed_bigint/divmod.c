@@ -0,0 +1,86 @@
+#include <stdio.h>
+#include <string.h>
+#include "slowlibs/fixed_bigint.h"
+
+static uint64_t rng = 0xa4093822299f31d0;
+
+static void fill(slowlib_fbig_part* p, size_t np, size_t bits)
+{
+  size_t i;
+  for (i = 0; i < np * slowlib_fbig_part_sz; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    ((uint8_t*)p)[i] = i * 8 < bits ? (uint8_t)rng : 0;
+  }
+}
+
+static int failed = 0;
+
+/* checks r == umod(a, m), r < m, and q * m + r == a */
+#define TEST_DIV(wa, wm, mod_bits, iters)                                  \
+  do {                                                                     \
+    slowlib_fbig_var(wa, a);                                               \
+    slowlib_fbig_var(wm, m);                                               \
+    slowlib_fbig_var(wa, q);                                               \
+    slowlib_fbig_var(wm, r);                                               \
+    slowlib_fbig_var(wa, expected);                                        \
+    slowlib_fbig_part back[slowlib_fbig(wa) + slowlib_fbig(wm) + 1];       \
+    slowlib_fbig_part qm[slowlib_fbig(wa) + slowlib_fbig(wm)];             \
+    for (int _it = 0; _it < (iters); _it++) {                              \
+      fill(a, slowlib_fbig_np(a), (wa));                                   \
+      fill(m, slowlib_fbig_np(m), (mod_bits));                             \
+      if (_it % 4 == 1) /* divisor with its top bit set */                 \
+        m[((mod_bits) - 1) / slowlib_fbig_part_bits] |=                    \
+            (slowlib_fbig_part)1 << (((mod_bits) - 1) % slowlib_fbig_part_bits); \
+      if (_it % 4 == 2) /* lots of all-ones parts: qhat corrections */     \
+        memset(a, 0xff, sizeof(a) / 2);                                    \
+      if (_it % 4 == 3)                                                    \
+        m[0] |= 1;                                                         \
+      slowlib_fbig_udivmod_vt(q, r, a, m);                                 \
+      slowlib_fbig_umod(expected, a, m);                                   \
+      if (memcmp(r, expected, sizeof(r))) {                                \
+        printf("divmod %u / %u (%u): remainder mismatch\n", (unsigned)(wa), \
+               (unsigned)(wm), (unsigned)(mod_bits));                      \
+        failed = 1;                                                        \
+      }                                                                    \
+      slowlib_fbig_mul(qm, q, m);                                          \
+      slowlib_fbig_add(back, qm, r);                                       \
+      if (memcmp(back, a, sizeof(a))) {                                    \
+        printf("divmod %u / %u (%u): q * m + r != a\n", (unsigned)(wa),    \
+               (unsigned)(wm), (unsigned)(mod_bits));                      \
+        failed = 1;                                                        \
+      }                                                                    \
+    }                                                                      \
+  } while (0)
+
+int main()
+{
+  /* single part divisors */
+  TEST_DIV(256, 32, 32, 100);
+  TEST_DIV(256, 32, 7, 100);
+  TEST_DIV(256, 256, 20, 100);
+
+  TEST_DIV(256, 128, 128, 100);
+  TEST_DIV(256, 256, 100, 100);
+  TEST_DIV(256, 256, 256, 100);
+  TEST_DIV(1024, 512, 500, 50);
+  TEST_DIV(2048, 1024, 1024, 20);
+
+  /* a < m */
+  {
+    slowlib_fbig_var(128, a);
+    slowlib_fbig_var(256, m);
+    slowlib_fbig_var(128, q);
+    slowlib_fbig_var(256, r);
+    fill(a, slowlib_fbig_np(a), 128);
+    fill(m, slowlib_fbig_np(m), 256);
+    slowlib_fbig_udivmod_vt(q, r, a, m);
+    if (memcmp(r, a, sizeof(a)) || r[slowlib_fbig_np(r) - 1] != 0 || q[0] != 0)
+      failed = 1;
+  }
+
+  if (!failed)
+    printf("ok\n");
+  return failed;
+}
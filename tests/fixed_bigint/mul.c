@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+
+/* lower than the default, so that small odd part counts recurse */
+#ifndef SLOWLIBS_FBIG_KARATSUBA_BITS
+#define SLOWLIBS_FBIG_KARATSUBA_BITS (8 * SLOWLIBS_FBIG_PART_BITS)
+#endif
+#include "slowlibs/fixed_bigint.h"
+
+/* width of n parts */
+#define PARTS(n) ((n) * SLOWLIBS_FBIG_PART_BITS)
+
+static uint64_t rng = 0x13198a2e03707344;
+
+static void fill(slowlib_fbig_part* p, size_t np)
+{
+  size_t i;
+  for (i = 0; i < np * slowlib_fbig_part_sz; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    ((uint8_t*)p)[i] = (uint8_t)rng;
+  }
+}
+
+/* plain schoolbook */
+static void mul_ref(slowlib_fbig_part* out,
+                    slowlib_fbig_part const* a,
+                    size_t na,
+                    slowlib_fbig_part const* b,
+                    size_t nb)
+{
+  size_t i, j;
+  for (i = 0; i < na + nb; i++)
+    out[i] = 0;
+  for (i = 0; i < na; i++) {
+    slowlib_fbig_part carry = 0;
+    for (j = 0; j < nb; j++) {
+      slowlib_fbig_double_part prod =
+          (slowlib_fbig_double_part)a[i] * b[j] + out[i + j] + carry;
+      out[i + j] = (slowlib_fbig_part)prod;
+      carry = (slowlib_fbig_part)(prod >> slowlib_fbig_part_bits);
+    }
+    out[i + nb] = carry;
+  }
+}
+
+static int failed = 0;
+
+#define TEST_WIDTHS(wa, wb, iters)                                         \
+  do {                                                                     \
+    slowlib_fbig_var(wa, a);                                               \
+    slowlib_fbig_var(wb, b);                                               \
+    slowlib_fbig_part got[slowlib_fbig(wa) + slowlib_fbig(wb)];            \
+    slowlib_fbig_part expected[slowlib_fbig(wa) + slowlib_fbig(wb)];       \
+    for (int _it = 0; _it < (iters); _it++) {                              \
+      fill(a, slowlib_fbig_np(a));                                         \
+      fill(b, slowlib_fbig_np(b));                                         \
+      if (_it == 0) {                                                      \
+        memset(a, 0xff, sizeof(a));                                        \
+        memset(b, 0xff, sizeof(b));                                        \
+      }                                                                    \
+      mul_ref(expected, a, slowlib_fbig_np(a), b, slowlib_fbig_np(b));     \
+      slowlib_fbig_mul(got, a, b);                                         \
+      if (memcmp(got, expected, sizeof(got))) {                            \
+        printf("mul %ux%u: mismatch\n", (unsigned)(wa), (unsigned)(wb));   \
+        failed = 1;                                                        \
+      }                                                                    \
+    }                                                                      \
+  } while (0)
+
+#define TEST_SQR(w, iters)                                                 \
+  do {                                                                     \
+    slowlib_fbig_var(w, a);                                                \
+    slowlib_fbig_part got[2 * slowlib_fbig(w)];                            \
+    slowlib_fbig_part expected[2 * slowlib_fbig(w)];                       \
+    for (int _it = 0; _it < (iters); _it++) {                              \
+      fill(a, slowlib_fbig_np(a));                                         \
+      if (_it == 0)                                                        \
+        memset(a, 0xff, sizeof(a));                                        \
+      mul_ref(expected, a, slowlib_fbig_np(a), a, slowlib_fbig_np(a));     \
+      slowlib_fbig_sqr(got, a);                                            \
+      if (memcmp(got, expected, sizeof(got))) {                            \
+        printf("sqr %u: mismatch\n", (unsigned)(w));                       \
+        failed = 1;                                                        \
+      }                                                                    \
+    }                                                                      \
+  } while (0)
+
+int main()
+{
+  /* Comba */
+  TEST_WIDTHS(PARTS(1), PARTS(1), 20);
+  TEST_WIDTHS(136, 128, 50);
+  TEST_WIDTHS(PARTS(7), PARTS(7), 50);
+  TEST_WIDTHS(2048, 64, 20);
+  TEST_SQR(PARTS(1), 20);
+  TEST_SQR(PARTS(7), 50);
+
+  /* Karatsuba, including odd part counts on every level */
+  TEST_WIDTHS(PARTS(8), PARTS(8), 20);
+  TEST_WIDTHS(PARTS(9), PARTS(9), 20);
+  TEST_WIDTHS(PARTS(17), PARTS(17), 20);
+  TEST_WIDTHS(PARTS(33), PARTS(33), 20);
+  TEST_WIDTHS(PARTS(64), PARTS(64), 10);
+  TEST_WIDTHS(PARTS(128), PARTS(128), 5);
+  TEST_SQR(PARTS(8), 20);
+  TEST_SQR(PARTS(17), 20);
+  TEST_SQR(PARTS(33), 20);
+  TEST_SQR(PARTS(128), 5);
+
+  if (!failed)
+    printf("ok\n");
+  return failed;
+}
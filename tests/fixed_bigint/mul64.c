@@ -0,0 +1,15 @@
+#ifdef __SIZEOF_INT128__
+
+/* the 64-bit parts Karatsuba has its own carry handling */
+#define SLOWLIBS_FBIG_PART_BITS 64
+#include "mul.c"
+
+#else
+
+/* 64-bit limbs not available: skip */
+int main()
+{
+  return 77;
+}
+
+#endif
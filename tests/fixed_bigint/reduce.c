@@ -0,0 +1,152 @@
+#include <stdio.h>
+#include <string.h>
+#include "slowlibs/fixed_bigint.h"
+
+static uint64_t rng = 0x243f6a8885a308d3;
+
+static void fill(slowlib_fbig_part* p, size_t np, size_t bits)
+{
+  size_t i;
+  for (i = 0; i < np * slowlib_fbig_part_sz; i++) {
+    rng ^= rng << 13;
+    rng ^= rng >> 7;
+    rng ^= rng << 17;
+    ((uint8_t*)p)[i] = i * 8 < bits ? (uint8_t)rng : 0;
+  }
+}
+
+static int failed = 0;
+
+static void check(char const* what,
+                  unsigned width,
+                  slowlib_fbig_part const* got,
+                  slowlib_fbig_part const* expected,
+                  size_t np)
+{
+  if (memcmp(got, expected, np * slowlib_fbig_part_sz)) {
+    printf("%s (%u bits): mismatch\n", what, width);
+    failed = 1;
+  }
+}
+
+/* compares against slowlib_fbig_umod, with the modulus using mod_bits of width */
+#define TEST_WIDTH(width, mod_bits, iters)                                 \
+  do {                                                                     \
+    slowlib_fbig_var(width, m);                                            \
+    slowlib_fbig_var(width, a);                                            \
+    slowlib_fbig_var(width, b);                                            \
+    slowlib_fbig_var(width, got);                                          \
+    slowlib_fbig_var(width, expected);                                     \
+    slowlib_fbig_part prod[2 * slowlib_fbig(width)];                       \
+    slowlib_fbig_mont_ctx(width, mont);                                    \
+    slowlib_fbig_barrett_ctx(width, barrett);                              \
+    for (int _it = 0; _it < (iters); _it++) {                              \
+      fill(m, slowlib_fbig_np(m), (mod_bits));                             \
+      m[0] |= 1;                                                           \
+      slowlib_fbig_mont_init(mont, m);                                     \
+      slowlib_fbig_barrett_init(barrett, m);                               \
+      fill(a, slowlib_fbig_np(a), (width));                                \
+      fill(b, slowlib_fbig_np(b), (width));                                \
+      slowlib_fbig_umod(a, a, m);                                          \
+      slowlib_fbig_umod(b, b, m);                                          \
+      slowlib_fbig_mul(prod, a, b);                                        \
+      slowlib_fbig_umod(prod, prod, m);                                    \
+      slowlib_fbig_trunc(expected, prod);                                  \
+                                                                           \
+      slowlib_fbig_mul(prod, a, b);                                        \
+      slowlib_fbig_barrett(got, prod, barrett);                            \
+      check("barrett", (width), got, expected, slowlib_fbig_np(got));      \
+                                                                           \
+      slowlib_fbig_to_mont(a, a, mont);                                    \
+      slowlib_fbig_to_mont(b, b, mont);                                    \
+      slowlib_fbig_mont_mul(got, a, b, mont);                              \
+      slowlib_fbig_from_mont(got, got, mont);                              \
+      check("mont_mul", (width), got, expected, slowlib_fbig_np(got));     \
+    }                                                                      \
+  } while (0)
+
+int main()
+{
+  TEST_WIDTH(136, 130, 50);
+  TEST_WIDTH(256, 256, 50);
+  TEST_WIDTH(256, 100, 50);
+  TEST_WIDTH(1024, 1024, 10);
+  TEST_WIDTH(1024, 1000, 10);
+
+  /* 2^130 - 5 */
+  {
+    slowlib_fbig_const(136, P,
+                       {slowlib_fbig_const_part_u64(0xfffffffffffffffb),
+                        slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                        slowlib_fbig_const_part_u64(0x3)});
+    slowlib_fbig_var(136, got);
+    slowlib_fbig_var(136, expected);
+    slowlib_fbig_var(264, prod);
+    slowlib_fbig_barrett_ctx(136, barrett);
+    slowlib_fbig_barrett_init(barrett, P);
+    for (int i = 0; i < 50; i++) {
+      fill(prod, slowlib_fbig_np(prod), 258);
+      slowlib_fbig_barrett(got, prod, barrett);
+      slowlib_fbig_umod(prod, prod, P);
+      slowlib_fbig_trunc(expected, prod);
+      check("barrett 2^130-5", 136, got, expected, slowlib_fbig_np(got));
+    }
+  }
+
+  /* pseudo-Mersenne */
+  {
+    slowlib_fbig_const(136, P130,
+                       {slowlib_fbig_const_part_u64(0xfffffffffffffffb),
+                        slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                        slowlib_fbig_const_part_u64(0x3)});
+    slowlib_fbig_const(256, P255,
+                       {slowlib_fbig_const_part_u64(0xffffffffffffffed),
+                        slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                        slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                        slowlib_fbig_const_part_u64(0x7fffffffffffffff)});
+    slowlib_fbig_const(128, P127,
+                       {slowlib_fbig_const_part_u64(0xffffffffffffffff),
+                        slowlib_fbig_const_part_u64(0x7fffffffffffffff)});
+    slowlib_fbig_var(136, got130);
+    slowlib_fbig_var(256, got255);
+    slowlib_fbig_var(128, got127);
+    slowlib_fbig_var(264, a264);
+    slowlib_fbig_var(512, a512);
+    slowlib_fbig_var(256, a256);
+    slowlib_fbig_var(512, expected);
+
+    for (int i = 0; i < 100; i++) {
+      /* also hit values just below the top */
+      fill(a264, slowlib_fbig_np(a264), i % 2 ? 264 : 131);
+      slowlib_fbig_reduce_pm(got130, a264, 130, 5);
+      slowlib_fbig_umod(a264, a264, P130);
+      check("reduce_pm 2^130-5", 264, got130, a264, slowlib_fbig_np(got130));
+
+      fill(a512, slowlib_fbig_np(a512), i % 2 ? 512 : 256);
+      slowlib_fbig_reduce_pm(got255, a512, 255, 19);
+      slowlib_fbig_umod(expected, a512, P255);
+      check("reduce_pm 2^255-19", 512, got255, expected,
+            slowlib_fbig_np(got255));
+
+      fill(a256, slowlib_fbig_np(a256), i % 2 ? 256 : 128);
+      slowlib_fbig_reduce_pm(got127, a256, 127, 1);
+      slowlib_fbig_umod(a256, a256, P127);
+      check("reduce_pm 2^127-1", 256, got127, a256, slowlib_fbig_np(got127));
+    }
+
+    /* p itself, and all ones */
+    slowlib_fbig__copy_mod(a264, P130);
+    slowlib_fbig_reduce_pm(got130, a264, 130, 5);
+    slowlib_fbig_zext_scalar(a264, 0);
+    check("reduce_pm p", 130, got130, a264, slowlib_fbig_np(got130));
+    for (size_t j = 0; j < slowlib_fbig_np(a512); j++)
+      a512[j] = (slowlib_fbig_part)~(slowlib_fbig_part)0;
+    slowlib_fbig_reduce_pm(got255, a512, 255, 19);
+    slowlib_fbig_umod(expected, a512, P255);
+    check("reduce_pm ones", 512, got255, expected, slowlib_fbig_np(got255));
+  }
+
+  if (!failed)
+    printf("ok\n");
+  return failed;
+}
@@ -0,0 +1,2 @@
+#define SLOWCRYPT_ALLOW_TIMING_ATTACKS
+#include "reduce.c"
@@ -0,0 +1,14 @@
+#ifdef __SIZEOF_INT128__
+
+#define SLOWLIBS_FBIG_PART_BITS 64
+#include "test_vector_fbig.c"
+
+#else
+
+/* 64-bit limbs not available: skip */
+int main()
+{
+  return 77;
+}
+
+#endif
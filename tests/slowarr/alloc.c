@@ -0,0 +1,76 @@
+#include <stdio.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowarr.h"
+
+SLOWARR_HeaderA(int);
+SLOWARR_ImplA(int);
+
+static int failed = 0;
+
+static void check_arr(char const* what, T(SLOWARR__A, int) * arr, int n)
+{
+  int i;
+  if (arr->len != (SLOWARR_SZT)n) {
+    printf("%s: len %lu, expected %d\n", what, (unsigned long)arr->len, n);
+    failed = 1;
+    return;
+  }
+  for (i = 0; i < n; i++)
+    if (arr->data[i] != i * 7) {
+      printf("%s: wrong element %d\n", what, i);
+      failed = 1;
+      return;
+    }
+}
+
+/* several arrays growing at the same time, interleaved */
+static void fill_many(slowarr_allocator const* alloc, char const* what)
+{
+  T(SLOWARR__A, int) arrs[8];
+  int i, j;
+
+  for (j = 0; j < 8; j++)
+    arrs[j] = F(SLOWARR__A, int, make)(alloc);
+  for (i = 0; i < 1000; i++)
+    for (j = 0; j < 8; j++)
+      if (i < 100 * (j + 1))
+        F(SLOWARR__A, int, push)(&arrs[j], i * 7);
+  for (j = 0; j < 8; j++) {
+    check_arr(what, &arrs[j], 100 * (j + 1));
+    /* shrinks */
+    while (arrs[j].len > 10)
+      F(SLOWARR__A, int, pop)(&arrs[j]);
+    check_arr(what, &arrs[j], 10);
+  }
+  for (j = 0; j < 8; j++)
+    F(SLOWARR__A, int, unsafeClear)(&arrs[j]);
+}
+
+int main()
+{
+  slowarr_arena arena;
+  slowarr_pool pool;
+  slowarr_allocator alloc;
+  int round;
+
+  /* null allocator: SLOWARR_REALLOC */
+  fill_many((slowarr_allocator const*)0, "default");
+
+  slowarr_arena_init(&arena, 4096);
+  alloc = slowarr_arena_allocator(&arena);
+  for (round = 0; round < 3; round++) {
+    fill_many(&alloc, "arena");
+    slowarr_arena_reset(&arena);
+  }
+  slowarr_arena_deinit(&arena);
+
+  slowarr_pool_init(&pool);
+  alloc = slowarr_pool_allocator(&pool);
+  for (round = 0; round < 3; round++)
+    fill_many(&alloc, "pool");
+  slowarr_pool_deinit(&pool);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
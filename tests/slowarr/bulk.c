@@ -0,0 +1,119 @@
+#include <stdio.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowarr.h"
+
+SLOWARR_Header(int);
+SLOWARR_Impl(int);
+
+static int failed = 0;
+
+static void check(char const* what,
+                  T(SLOWARR, int) const* arr,
+                  int const* expected,
+                  int n)
+{
+  int i;
+  if (arr->len != (SLOWARR_SZT)n || arr->len > arr->cap) {
+    printf("%s: len %lu, expected %d\n", what, (unsigned long)arr->len, n);
+    failed = 1;
+    return;
+  }
+  for (i = 0; i < n; i++)
+    if (arr->data[i] != expected[i]) {
+      printf("%s: element %d is %d, expected %d\n", what, i, arr->data[i],
+             expected[i]);
+      failed = 1;
+      return;
+    }
+}
+
+int main()
+{
+  static int const abc[] = {1, 2, 3};
+  T(SLOWARR, int) arr, other;
+  int removed[4];
+  int* p;
+  int i;
+
+  SLOWARR_MEMZERO(&arr, sizeof(arr));
+  SLOWARR_MEMZERO(&other, sizeof(other));
+
+  F(SLOWARR, int, pushN)(&arr, abc, 3);
+  {
+    int e[] = {1, 2, 3};
+    check("pushN", &arr, e, 3);
+  }
+
+  /* source inside of the array itself */
+  F(SLOWARR, int, appendArray)(&arr, &arr);
+  F(SLOWARR, int, pushN)(&arr, arr.data + 1, 2);
+  {
+    int e[] = {1, 2, 3, 1, 2, 3, 2, 3};
+    check("appendArray self", &arr, e, 8);
+  }
+
+  F(SLOWARR, int, insertAt)(&arr, 0, 9);
+  F(SLOWARR, int, insertAt)(&arr, arr.len, 8);
+  F(SLOWARR, int, insertRange)(&arr, 2, abc, 3);
+  {
+    int e[] = {9, 1, 1, 2, 3, 2, 3, 1, 2, 3, 2, 3, 8};
+    check("insert", &arr, e, 13);
+  }
+
+  F(SLOWARR, int, removeRange)(&arr, 1, 4, removed);
+  F(SLOWARR, int, removeRange)(&arr, 0, 0, (int*)0);
+  {
+    int e[] = {9, 2, 3, 1, 2, 3, 2, 3, 8};
+    int r[] = {1, 1, 2, 3};
+    check("removeRange", &arr, e, 9);
+    for (i = 0; i < 4; i++)
+      if (removed[i] != r[i]) {
+        printf("removeRange: wrong removed element %d\n", i);
+        failed = 1;
+      }
+  }
+
+  F(SLOWARR, int, resize)(&arr, 3);
+  F(SLOWARR, int, resize)(&arr, 5);
+  {
+    int e[] = {9, 2, 3, 0, 0};
+    check("resize", &arr, e, 5);
+  }
+
+  p = F(SLOWARR, int, pushUninit)(&arr, 100);
+  for (i = 0; i < 100; i++)
+    p[i] = i;
+  if (arr.len != 105 || arr.data[104] != 99 || arr.data[4] != 0) {
+    printf("pushUninit: wrong result\n");
+    failed = 1;
+  }
+
+  /* grows to what is needed, if that is more than the growth rate */
+  F(SLOWARR, int, reserve)(&other, 1000);
+  if (other.cap < 1000 || other.cap > 1250 || other.len != 0) {
+    printf("reserve: cap %lu\n", (unsigned long)other.cap);
+    failed = 1;
+  }
+  F(SLOWARR, int, appendArray)(&other, &arr);
+  F(SLOWARR, int, removeRange)(&other, 0, other.len, (int*)0);
+  if (other.len != 0) {
+    printf("removeRange all: len %lu\n", (unsigned long)other.len);
+    failed = 1;
+  }
+
+  /* single element arrays have to grow too */
+  F(SLOWARR, int, push)(&other, 5);
+  F(SLOWARR, int, shrink)(&other);
+  F(SLOWARR, int, push)(&other, 6);
+  {
+    int e[] = {5, 6};
+    check("push after shrink", &other, e, 2);
+  }
+
+  F(SLOWARR, int, unsafeClear)(&arr);
+  F(SLOWARR, int, unsafeClear)(&other);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
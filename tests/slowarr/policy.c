@@ -0,0 +1,107 @@
+#include <stdio.h>
+#include <stdlib.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowarr.h"
+
+SLOWARR_HeaderA(int);
+SLOWARR_ImplA(int);
+
+static int failed = 0;
+static unsigned long reallocs = 0;
+
+static void* counting_realloc(void* ctx,
+                              void* ptr,
+                              SLOWARR_SZT old,
+                              SLOWARR_SZT news)
+{
+  (void)ctx;
+  (void)old;
+  reallocs++;
+  return realloc(ptr, news);
+}
+
+static void counting_free(void* ctx, void* ptr, SLOWARR_SZT size)
+{
+  (void)ctx;
+  (void)size;
+  free(ptr);
+}
+
+int main()
+{
+  slowarr_allocator alloc;
+  T(SLOWARR__A, int) arr;
+  SLOWARR_SZT cap;
+  int i, x;
+
+  alloc.realloc = counting_realloc;
+  alloc.free = counting_free;
+  alloc.ctx = 0;
+  arr = F(SLOWARR__A, int, make)(&alloc);
+
+  for (i = 0; i < 1000; i++)
+    F(SLOWARR__A, int, push)(&arr, i);
+  if (reallocs > 20) {
+    printf("growing: %lu reallocations\n", reallocs);
+    failed = 1;
+  }
+
+  /* caps are rounded to size classes */
+  if ((arr.cap * sizeof(int)) % 64) {
+    printf("cap %lu is not rounded\n", (unsigned long)arr.cap);
+    failed = 1;
+  }
+
+  /* alternating push and pop must not reallocate */
+  while (arr.len > arr.cap / 2)
+    F(SLOWARR__A, int, pop)(&arr);
+  cap = arr.cap;
+  reallocs = 0;
+  for (i = 0; i < 10000; i++) {
+    F(SLOWARR__A, int, push)(&arr, i);
+    (void)F(SLOWARR__A, int, pop)(&arr);
+    (void)F(SLOWARR__A, int, pop)(&arr);
+    F(SLOWARR__A, int, push)(&arr, i);
+  }
+  if (reallocs || arr.cap != cap) {
+    printf("push / pop: %lu reallocations\n", reallocs);
+    failed = 1;
+  }
+
+  /* but it shrinks eventually */
+  while (arr.len > 10)
+    F(SLOWARR__A, int, pop)(&arr);
+  if (arr.cap >= cap / 4) {
+    printf("did not shrink: cap %lu\n", (unsigned long)arr.cap);
+    failed = 1;
+  }
+
+  /* swapRemove: 0..9 -> 9 1 2 3 4 5 6 7 8 -> 9 1 2 8 4 5 6 7 */
+  F(SLOWARR__A, int, unsafeClear)(&arr);
+  for (i = 0; i < 10; i++)
+    F(SLOWARR__A, int, push)(&arr, i);
+  F(SLOWARR__A, int, swapRemove)(&arr, &x, 0);
+  if (x != 0)
+    failed = 1;
+  F(SLOWARR__A, int, swapRemove)(&arr, &x, 3);
+  if (x != 3)
+    failed = 1;
+  F(SLOWARR__A, int, swapRemove)(&arr, &x, arr.len - 1);
+  if (x != 7)
+    failed = 1;
+  {
+    int e[] = {9, 1, 2, 8, 4, 5, 6};
+    if (arr.len != 7)
+      failed = 1;
+    for (i = 0; i < 7 && !failed; i++)
+      if (arr.data[i] != e[i]) {
+        printf("swapRemove: element %d is %d\n", i, arr.data[i]);
+        failed = 1;
+      }
+  }
+  F(SLOWARR__A, int, unsafeClear)(&arr);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
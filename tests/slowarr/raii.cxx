@@ -0,0 +1,168 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <utility>
+
+static long live_blocks = 0;
+static void* counting_realloc(void* ptr, size_t news)
+{
+  void* n;
+  if (!news) {
+    free(ptr);
+    live_blocks--;
+    return 0;
+  }
+  n = realloc(ptr, news);
+  if (!ptr && n)
+    live_blocks++;
+  return n;
+}
+static void counting_free(void* ptr)
+{
+  if (ptr)
+    live_blocks--;
+  free(ptr);
+}
+
+#define SLOWARR_REALLOC(ptr, old, news) counting_realloc(ptr, news)
+#define SLOWARR_FREE(ptr, size) counting_free(ptr)
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowarr.h"
+
+struct point
+{
+  int x, y;
+  point() = default;
+  point(int x, int y) : x(x), y(y) {}
+};
+
+SLOWARR_Header(point);
+SLOWARR_Impl(point);
+
+typedef char const* cstr;
+SLOWARR_Header(cstr);
+SLOWARR_Impl(cstr);
+
+static int destroyed = 0;
+struct counted
+{
+  int v;
+  ~counted()
+  {
+    destroyed++;
+  }
+};
+
+/* has a destructor, but is still trivially relocatable */
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wclass-memaccess"
+#endif
+SLOWARR_Header(counted);
+SLOWARR_Impl(counted);
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+static int failed = 0;
+
+#define CHECK(what, cond)            \
+  do {                               \
+    if (!(cond)) {                   \
+      printf("failed: %s\n", what);  \
+      failed = 1;                    \
+    }                                \
+  } while (0)
+
+static SlowArr<point> make_points(int n)
+{
+  SlowArr<point> r;
+  r.reserve(n);
+  for (int i = 0; i < n; i++)
+    r.emplace_back(i, -i);
+  return r;
+}
+
+/* C code that appends to an array */
+static void c_append(T(SLOWARR, point) * arr)
+{
+  point p(100, 100);
+  F(SLOWARR, point, push)(arr, p);
+}
+
+int main(int argc, char const** argv)
+{
+  {
+    SlowArr<point> a = make_points(50);
+    CHECK("emplace_back", a.size() == 50 && a[49].x == 49 && a[49].y == -49);
+    CHECK("reserve", a.capacity() >= 50);
+
+    SlowArr<point> b = std::move(a);
+    CHECK("move construct", a.size() == 0 && !a.data() && b.size() == 50);
+
+    a = make_points(3);
+    a = std::move(b);
+    CHECK("move assign", a.size() == 50 && b.size() == 0);
+
+    SlowArr<point> c = a.clone();
+    c[0].x = 7;
+    CHECK("clone", c.size() == 50 && a[0].x == 0 && c.data() != a.data());
+
+    /* clones keep zeroize */
+    c.c()->attr |= SLOWARR__ZEROIZE;
+    SlowArr<point> z = c.clone();
+    CHECK("clone attr", z.c()->attr == SLOWARR__ZEROIZE);
+
+    /* to C and back, without copying */
+    point* data = a.data();
+    c_append(a.c());
+    CHECK("c()", a.size() == 51 && a[50].x == 100);
+    T(SLOWARR, point) raw = a.release();
+    CHECK("release", a.size() == 0 && raw.len == 51);
+    SlowArr<point> d = raw;
+    CHECK("adopt", d.size() == 51 && (d.data() == data || d.capacity() >= 51));
+
+    int sum = 0;
+    for (point const& p : d)
+      sum += p.x;
+    CHECK("iterate", sum == 49 * 50 / 2 + 100);
+
+    d.pop_back();
+    d.clear();
+    CHECK("clear", d.empty());
+
+    /* the argument references an element, that moves when growing */
+    SlowArr<point> e = make_points(4);
+    while (e.size() < e.capacity())
+      e.emplace_back(1, 1);
+    e.push_back(e[0]);
+    e.emplace_back(e[1].x, e[1].y);
+    CHECK("push_back own element",
+          e[e.size() - 2].x == 0 && e[e.size() - 1].x == 1);
+
+#if __cplusplus >= 202002L
+    std::span<point> sp = c;
+    CHECK("span", sp.size() == 50 && sp.data() == c.data());
+#endif
+  }
+  CHECK("no leaks", live_blocks == 0);
+
+  {
+    /* borrowed: must not be freed */
+    T(SLOWARR, cstr) arr = F(SLOWARR, cstr, borrow)(argv, argc);
+    SlowArr<cstr> arrx = {arr};
+    CHECK("borrow", arrx.size() == (size_t)argc && arrx[0] == argv[0]);
+  }
+
+  {
+    /* borrowed elements are not destroyed */
+    counted buf[2] = {{1}, {2}};
+    SlowArr<counted> b = {F(SLOWARR, counted, borrow)(buf, 2)};
+    destroyed = 0;
+    b.pop_back();
+    CHECK("borrow pop_back", destroyed == 0 && b.size() == 1);
+  }
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
@@ -0,0 +1,145 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+static unsigned long allocs = 0;
+static void* counting_realloc(void* ptr, unsigned long news)
+{
+  if (!ptr)
+    allocs++;
+  return realloc(ptr, news);
+}
+
+#define SLOWARR_REALLOC(ptr, old, news) counting_realloc(ptr, news)
+#define SLOWARR_FREE(ptr, size) free(ptr)
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowarr.h"
+
+SLOWARR_HeaderSBO(int, 8);
+SLOWARR_ImplSBO(int, 8);
+SLOWARR_HeaderSBO(int, 1);
+SLOWARR_ImplSBO(int, 1);
+SLOWARR_HeaderSBO(int, 3);
+SLOWARR_ImplSBO(int, 3);
+SLOWARR_HeaderSBO(int, 5);
+SLOWARR_ImplSBO(int, 5);
+
+/* sizeof is not a power of two */
+typedef struct
+{
+  int a, b, c;
+} B12;
+SLOWARR_HeaderSBO(B12, 8);
+SLOWARR_ImplSBO(B12, 8);
+
+static int failed = 0;
+
+static void check(char const* what, T(SLOWARR__S8, int) * arr, int n)
+{
+  int i;
+  int* p = F(SLOWARR__S8, int, ptr)(arr);
+  if (arr->len != (SLOWARR_SZT)n) {
+    printf("%s: len %lu, expected %d\n", what, (unsigned long)arr->len, n);
+    failed = 1;
+    return;
+  }
+  for (i = 0; i < n; i++)
+    if (p[i] != i) {
+      printf("%s: element %d is %d\n", what, i, p[i]);
+      failed = 1;
+      return;
+    }
+}
+
+/* the first N pushes stay inline, the next one allocates once */
+#define CHECK_INLINE(K, N, V)                                           \
+  do {                                                                  \
+    T(SLOWARR__##K, V) a = {0};                                         \
+    V v;                                                                \
+    int j;                                                              \
+    SLOWARR_MEMZERO(&v, sizeof(v));                                     \
+    allocs = 0;                                                         \
+    for (j = 0; j < N; j++)                                             \
+      F(SLOWARR__##K, V, push)(&a, v);                                  \
+    if (allocs || a.data || a.cap != N) {                               \
+      printf(#K " " #V ": allocated after %d pushes\n", N);             \
+      failed = 1;                                                       \
+    }                                                                   \
+    F(SLOWARR__##K, V, push)(&a, v);                                    \
+    if (allocs != 1 || !a.data) {                                       \
+      printf(#K " " #V ": did not spill\n");                            \
+      failed = 1;                                                       \
+    }                                                                   \
+    F(SLOWARR__##K, V, unsafeClear)(&a);                                \
+  } while (0)
+
+int main()
+{
+  T(SLOWARR__S8, int) arr = {0}, copy;
+  int nums[] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  int i, x;
+
+  for (i = 0; i < 8; i++)
+    F(SLOWARR__S8, int, push)(&arr, i);
+  check("inline", &arr, 8);
+  if (allocs || arr.data) {
+    printf("inline: allocated\n");
+    failed = 1;
+  }
+
+  /* copies don't share inline storage */
+  copy = arr;
+  F(SLOWARR__S8, int, ptr)(&copy)[0] = 5;
+  check("copy", &arr, 8);
+
+  F(SLOWARR__S8, int, push)(&arr, 8);
+  F(SLOWARR__S8, int, pushN)(&arr, nums + 9, 3);
+  check("spilled", &arr, 12);
+  if (allocs != 1 || !arr.data) {
+    printf("spilled: %lu allocations\n", allocs);
+    failed = 1;
+  }
+
+  /* shrinks back into the struct */
+  while (arr.len > 1)
+    F(SLOWARR__S8, int, pop)(&arr);
+  check("shrunk", &arr, 1);
+  if (arr.data) {
+    printf("shrunk: still on the heap\n");
+    failed = 1;
+  }
+
+  F(SLOWARR__S8, int, insertRange)(&arr, 1, nums + 1, 11);
+  F(SLOWARR__S8, int, removeRange)(&arr, 3, 9, (int*)0);
+  F(SLOWARR__S8, int, swapRemove)(&arr, &x, 0);
+  if (x != 0 || arr.len != 2 || arr.inl[0] != 2 || arr.inl[1] != 1) {
+    printf("bulk: wrong result\n");
+    failed = 1;
+  }
+  F(SLOWARR__S8, int, unsafeClear)(&arr);
+
+  /* zeroize clears the inline storage when spilling */
+  arr.attr = SLOWARR__ZEROIZE;
+  F(SLOWARR__S8, int, pushN)(&arr, nums, 8);
+  F(SLOWARR__S8, int, push)(&arr, 8);
+  for (i = 0; i < 8; i++)
+    if (arr.inl[i]) {
+      printf("zeroize: inline storage not cleared\n");
+      failed = 1;
+      break;
+    }
+  check("zeroize", &arr, 9);
+  F(SLOWARR__S8, int, unsafeClear)(&arr);
+
+  CHECK_INLINE(S1, 1, int);
+  CHECK_INLINE(S3, 3, int);
+  CHECK_INLINE(S5, 5, int);
+  CHECK_INLINE(S8, 8, int);
+  CHECK_INLINE(S8, 8, B12);
+
+  arr = F(SLOWARR__S8, int, borrow)(nums, 12);
+  check("borrow", &arr, 12);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowmap.h"
+
+typedef char const* cstr;
+
+SLOWMAP_Header(int, int);
+SLOWMAP_Impl(int, int, SLOWMAP_HASH_INT, SLOWMAP_EQ);
+
+SLOWMAP_Header(cstr, int);
+SLOWMAP_Impl(cstr, int, SLOWMAP_HASH_STR, SLOWMAP_EQ_STR);
+
+/* all keys collide */
+#define BAD_HASH(k) 5
+SLOWMAP_Header(unsigned, int);
+SLOWMAP_Impl(unsigned, int, BAD_HASH, SLOWMAP_EQ);
+
+static int failed = 0;
+
+#define NKEYS 2000
+/* model: value + 1, or 0 if not in the map */
+static int model[NKEYS];
+
+static unsigned long rng = 1;
+static int next_key(void)
+{
+  rng = rng * 6364136223846793005ULL + 1442695040888963407ULL;
+  return (int)((rng >> 33) % NKEYS);
+}
+
+static void check_model(T(SLOWARR__M__int, int) * m, char const* what)
+{
+  SLOWARR_SZT it = 0, count = 0, expected = 0;
+  T(SLOWARR__ME__int, int) * e;
+  int k, *v;
+
+  for (k = 0; k < NKEYS; k++) {
+    v = F(SLOWARR__M__int, int, get)(m, k * 7919);
+    if (model[k])
+      expected++;
+    if ((v == 0) != (model[k] == 0) || (v && *v != model[k] - 1)) {
+      printf("%s: key %d is wrong\n", what, k);
+      failed = 1;
+      return;
+    }
+  }
+  while ((e = F(SLOWARR__M__int, int, next)(m, &it))) {
+    count++;
+    if (e->key % 7919 || model[e->key / 7919] != e->val + 1)
+      failed = 1;
+  }
+  if (count != expected || m->len != expected) {
+    printf("%s: iterated %lu, expected %lu\n", what, (unsigned long)count,
+           (unsigned long)expected);
+    failed = 1;
+  }
+}
+
+static void run(slowarr_allocator const* alloc, char const* what)
+{
+  T(SLOWARR__M__int, int) m = F(SLOWARR__M__int, int, make)(alloc);
+  int i, k, v, found;
+
+  for (k = 0; k < NKEYS; k++)
+    model[k] = 0;
+
+  for (i = 0; i < 20000; i++) {
+    k = next_key();
+    if (i % 3 == 2) {
+      found = F(SLOWARR__M__int, int, remove)(&m, k * 7919, &v);
+      if (found != (model[k] != 0) || (found && v != model[k] - 1)) {
+        printf("%s: remove %d is wrong\n", what, k);
+        failed = 1;
+      }
+      model[k] = 0;
+    } else {
+      F(SLOWARR__M__int, int, put)(&m, k * 7919, i);
+      model[k] = i + 1;
+    }
+  }
+  check_model(&m, what);
+
+  /* remove everything */
+  for (k = 0; k < NKEYS; k++) {
+    F(SLOWARR__M__int, int, remove)(&m, k * 7919, (int*)0);
+    model[k] = 0;
+  }
+  check_model(&m, what);
+  F(SLOWARR__M__int, int, unsafeClear)(&m);
+}
+
+int main()
+{
+  slowarr_pool pool;
+  slowarr_allocator alloc;
+  T(SLOWARR__M__cstr, int) sm = {0};
+  T(SLOWARR__M__unsigned, int) bm = {0};
+  T(SLOWARR__ME__int, int) * entries;
+  T(SLOWARR__M__int, int) rm = {0};
+  char const* words[] = {"alpha", "beta", "gamma", "delta", "epsilon"};
+  char buf[8];
+  unsigned i;
+  int* v;
+
+  run((slowarr_allocator const*)0, "default");
+  slowarr_pool_init(&pool);
+  alloc = slowarr_pool_allocator(&pool);
+  run(&alloc, "pool");
+  slowarr_pool_deinit(&pool);
+
+  /* strings are compared by content */
+  for (i = 0; i < 5; i++)
+    F(SLOWARR__M__cstr, int, put)(&sm, words[i], (int)i);
+  buf[0] = 'g', buf[1] = 'a', buf[2] = 'm', buf[3] = 'm', buf[4] = 'a';
+  buf[5] = 0;
+  v = F(SLOWARR__M__cstr, int, get)(&sm, buf);
+  if (!v || *v != 2 || F(SLOWARR__M__cstr, int, get)(&sm, "gamm")) {
+    printf("strings: wrong lookup\n");
+    failed = 1;
+  }
+  F(SLOWARR__M__cstr, int, unsafeClear)(&sm);
+
+  /* collisions only: still correct */
+  for (i = 0; i < 100; i++)
+    F(SLOWARR__M__unsigned, int, put)(&bm, i, (int)i);
+  for (i = 0; i < 100; i += 2)
+    F(SLOWARR__M__unsigned, int, remove)(&bm, i, (int*)0);
+  for (i = 0; i < 100; i++) {
+    v = F(SLOWARR__M__unsigned, int, get)(&bm, i);
+    if ((v != 0) != (i % 2) || (v && *v != (int)i)) {
+      printf("collisions: key %u is wrong\n", i);
+      failed = 1;
+      break;
+    }
+  }
+  F(SLOWARR__M__unsigned, int, unsafeClear)(&bm);
+
+  /* no rehashing after reserve */
+  F(SLOWARR__M__int, int, reserve)(&rm, 1000);
+  entries = rm.entries;
+  for (i = 0; i < 1000; i++)
+    F(SLOWARR__M__int, int, put)(&rm, (int)i, 0);
+  if (rm.entries != entries || rm.len != 1000) {
+    printf("reserve: rehashed\n");
+    failed = 1;
+  }
+  F(SLOWARR__M__int, int, unsafeClear)(&rm);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
@@ -0,0 +1,152 @@
+#include <stdio.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowring.h"
+
+SLOWRING_Header(int);
+SLOWRING_Impl(int);
+
+static int failed = 0;
+
+/* compares against a simple array model */
+static int model[4096];
+static int model_head = 2048, model_len = 0;
+
+static void check(char const* what, T(SLOWARR__R, int) * r)
+{
+  SLOWARR_SZT i;
+  if (r->len != (SLOWARR_SZT)model_len || (r->cap & (r->cap - 1))) {
+    printf("%s: len %lu cap %lu, expected len %d\n", what,
+           (unsigned long)r->len, (unsigned long)r->cap, model_len);
+    failed = 1;
+    return;
+  }
+  for (i = 0; i < r->len; i++)
+    if (*F(SLOWARR__R, int, at)(r, i) != model[model_head + i]) {
+      printf("%s: element %lu is wrong\n", what, (unsigned long)i);
+      failed = 1;
+      return;
+    }
+}
+
+static void run(slowarr_allocator const* alloc, char const* what)
+{
+  T(SLOWARR__R, int) r = F(SLOWARR__R, int, make)(alloc);
+  int buf[100], i, step, x;
+  SLOWARR_SZT n, total;
+  int* p;
+
+  model_head = 2048;
+  model_len = 0;
+
+  /* mixed pushes and pops at both ends, to wrap around and grow
+   * while wrapped */
+  for (step = 0; step < 600; step++) {
+    switch ((step * 7) % 5) {
+      case 0:
+      case 1:
+        F(SLOWARR__R, int, pushBack)(&r, step);
+        model[model_head + model_len++] = step;
+        break;
+      case 2:
+        F(SLOWARR__R, int, pushFront)(&r, -step);
+        model[--model_head] = -step;
+        model_len++;
+        break;
+      case 3:
+        if (model_len) {
+          x = F(SLOWARR__R, int, popFront)(&r);
+          if (x != model[model_head])
+            failed = 1;
+          model_head++;
+          model_len--;
+        }
+        break;
+      case 4:
+        if (model_len) {
+          x = F(SLOWARR__R, int, popBack)(&r);
+          if (x != model[model_head + model_len - 1])
+            failed = 1;
+          model_len--;
+        }
+        break;
+    }
+  }
+  check(what, &r);
+
+  for (i = 0; i < 100; i++)
+    buf[i] = 1000 + i;
+  F(SLOWARR__R, int, pushBackN)(&r, buf, 100);
+  for (i = 0; i < 100; i++)
+    model[model_head + model_len++] = 1000 + i;
+  check(what, &r);
+
+  F(SLOWARR__R, int, popFrontN)(&r, buf, 50);
+  for (i = 0; i < 50; i++)
+    if (buf[i] != model[model_head + i])
+      failed = 1;
+  model_head += 50;
+  model_len -= 50;
+  check(what, &r);
+
+  /* spans: drain everything, the spans have to cover all elements */
+  total = 0;
+  while (r.len) {
+    p = F(SLOWARR__R, int, readSpan)(&r, &n);
+    for (i = 0; i < (int)n; i++)
+      if (p[i] != model[model_head + total + i])
+        failed = 1;
+    total += n;
+    F(SLOWARR__R, int, consume)(&r, n);
+  }
+  if (total != (SLOWARR_SZT)model_len) {
+    printf("%s: spans had %lu elements\n", what, (unsigned long)total);
+    failed = 1;
+  }
+
+  /* empty: the whole buffer is one write span */
+  F(SLOWARR__R, int, reserve)(&r, 300);
+  p = F(SLOWARR__R, int, writeSpan)(&r, &n);
+  if (n != r.cap || n < 300) {
+    printf("%s: write span of %lu\n", what, (unsigned long)n);
+    failed = 1;
+  }
+  for (i = 0; i < 300; i++)
+    p[i] = i;
+  F(SLOWARR__R, int, commit)(&r, 300);
+  for (i = 0; i < 300; i++)
+    if (F(SLOWARR__R, int, popFront)(&r) != i)
+      failed = 1;
+
+  F(SLOWARR__R, int, unsafeClear)(&r);
+  if (failed)
+    printf("%s: failed\n", what);
+}
+
+int main()
+{
+  slowarr_pool pool;
+  slowarr_allocator alloc;
+  T(SLOWARR__R, int) z = {0};
+
+  run((slowarr_allocator const*)0, "default");
+
+  slowarr_pool_init(&pool);
+  alloc = slowarr_pool_allocator(&pool);
+  run(&alloc, "pool");
+  slowarr_pool_deinit(&pool);
+
+  /* zeroize: popped slots are cleared */
+  z.attr = SLOWARR__ZEROIZE;
+  F(SLOWARR__R, int, pushBack)(&z, 5);
+  F(SLOWARR__R, int, pushBack)(&z, 6);
+  (void)F(SLOWARR__R, int, popFront)(&z);
+  if (z.data[0] != 0) {
+    printf("zeroize: not cleared\n");
+    failed = 1;
+  }
+  F(SLOWARR__R, int, unsafeClear)(&z);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
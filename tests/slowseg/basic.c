@@ -0,0 +1,127 @@
+#include <stdio.h>
+/* small chunks, so that the tests cross many chunk boundaries */
+#define SLOWSEG_CHUNK_SHIFT(T) (4)
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowseg.h"
+
+SLOWSEG_Header(int);
+SLOWSEG_Impl(int);
+
+static int failed = 0;
+
+static void check(char const* what, T(SLOWARR__SG, int) * s, int n)
+{
+  SLOWARR_SZT i, k, total = 0;
+  int* p;
+  if (s->len != (SLOWARR_SZT)n) {
+    printf("%s: len %lu, expected %d\n", what, (unsigned long)s->len, n);
+    failed = 1;
+    return;
+  }
+  for (i = 0; i < s->len; i++)
+    if (*F(SLOWARR__SG, int, at)(s, i) != (int)i) {
+      printf("%s: element %lu is wrong\n", what, (unsigned long)i);
+      failed = 1;
+      return;
+    }
+  for (i = 0; i < s->len; i += k) {
+    p = F(SLOWARR__SG, int, span)(s, i, &k);
+    if (k == 0 || k > 16 || p[0] != (int)i || p[k - 1] != (int)(i + k - 1)) {
+      printf("%s: span at %lu is wrong\n", what, (unsigned long)i);
+      failed = 1;
+      return;
+    }
+    total += k;
+  }
+  if (total != s->len) {
+    printf("%s: spans had %lu elements\n", what, (unsigned long)total);
+    failed = 1;
+  }
+}
+
+static void run(slowarr_allocator const* alloc, char const* what)
+{
+  T(SLOWARR__SG, int) s = F(SLOWARR__SG, int, make)(alloc);
+  int buf[100], i;
+  int *first, *mid;
+
+  F(SLOWARR__SG, int, push)(&s, 0);
+  first = F(SLOWARR__SG, int, at)(&s, 0);
+  for (i = 1; i < 20; i++)
+    *F(SLOWARR__SG, int, pushRef)(&s) = i;
+  mid = F(SLOWARR__SG, int, at)(&s, 17);
+  check(what, &s, 20);
+
+  /* grows the directory several times: elements must not move */
+  for (i = 0; i < 100; i++)
+    buf[i] = 20 + i;
+  F(SLOWARR__SG, int, pushN)(&s, buf, 100);
+  for (i = 120; i < 1000; i++)
+    F(SLOWARR__SG, int, push)(&s, i);
+  check(what, &s, 1000);
+  if (first != F(SLOWARR__SG, int, at)(&s, 0) ||
+      mid != F(SLOWARR__SG, int, at)(&s, 17) || *first != 0 || *mid != 17) {
+    printf("%s: elements moved\n", what);
+    failed = 1;
+  }
+
+  for (i = 999; i >= 990; i--)
+    if (F(SLOWARR__SG, int, pop)(&s) != i)
+      failed = 1;
+  check(what, &s, 990);
+
+  /* pop keeps chunks, shrink frees them */
+  while (s.len > 33)
+    (void)F(SLOWARR__SG, int, pop)(&s);
+  if (s.nchunks != 63) {
+    printf("%s: %lu chunks after pop\n", what, (unsigned long)s.nchunks);
+    failed = 1;
+  }
+  F(SLOWARR__SG, int, shrink)(&s);
+  if (s.nchunks != 3) {
+    printf("%s: %lu chunks after shrink\n", what, (unsigned long)s.nchunks);
+    failed = 1;
+  }
+  check(what, &s, 33);
+
+  F(SLOWARR__SG, int, reserve)(&s, 100);
+  if (s.nchunks != 9 || s.len != 33) {
+    printf("%s: %lu chunks after reserve\n", what, (unsigned long)s.nchunks);
+    failed = 1;
+  }
+
+  F(SLOWARR__SG, int, unsafeClear)(&s);
+  if (s.chunks || s.nchunks || s.len)
+    failed = 1;
+  if (failed)
+    printf("%s: failed\n", what);
+}
+
+int main()
+{
+  slowarr_pool pool;
+  slowarr_allocator alloc;
+  T(SLOWARR__SG, int) z = {0};
+
+  run((slowarr_allocator const*)0, "default");
+
+  slowarr_pool_init(&pool);
+  alloc = slowarr_pool_allocator(&pool);
+  run(&alloc, "pool");
+  slowarr_pool_deinit(&pool);
+
+  /* zeroize: popped slots are cleared */
+  z.attr = SLOWARR__ZEROIZE;
+  F(SLOWARR__SG, int, push)(&z, 5);
+  F(SLOWARR__SG, int, push)(&z, 6);
+  (void)F(SLOWARR__SG, int, pop)(&z);
+  if (z.chunks[0][1] != 0) {
+    printf("zeroize: not cleared\n");
+    failed = 1;
+  }
+  F(SLOWARR__SG, int, unsafeClear)(&z);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
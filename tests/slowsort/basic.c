@@ -0,0 +1,130 @@
+#include <stdio.h>
+#include <stdlib.h>
+#define SLOW_DEFINE_ACCESS
+#include "slowlibs/slowsort.h"
+
+typedef struct
+{
+  int key;
+  int order; /* position before sorting, to check stability */
+} item;
+
+#define INT_LESS(a, b) ((a) < (b))
+#define ITEM_LESS(a, b) ((a).key < (b).key)
+#define ITEM_KEY(x) SLOWSORT_KEY_I32((x).key)
+
+SLOWSORT_Header(int_asc, int);
+SLOWSORT_Impl(int_asc, int, INT_LESS);
+SLOWSORT_Header(item_key, item);
+SLOWSORT_Impl(item_key, item, ITEM_LESS);
+SLOWSORT_RadixHeader(item_key, item);
+SLOWSORT_RadixImpl(item_key, item, ITEM_KEY, 4);
+
+static int failed = 0;
+static unsigned long rng = 1;
+
+static int next_rand(void)
+{
+  rng = rng * 1103515245UL + 12345UL;
+  return (int)((rng >> 8) & 0x7FFFFFFF);
+}
+
+static int cmp_int(void const* a, void const* b)
+{
+  int x = *(int const*)a, y = *(int const*)b;
+  return (x > y) - (x < y);
+}
+
+/* 0: random, 1: few distinct, 2: sorted, 3: reversed, 4: all equal,
+ * 5: negative and positive */
+static int gen(int kind, int i, int n)
+{
+  switch (kind) {
+    case 0:
+      return next_rand();
+    case 1:
+      return next_rand() % 4;
+    case 2:
+      return i;
+    case 3:
+      return n - i;
+    case 4:
+      return 42;
+    default:
+      return next_rand() - 0x40000000;
+  }
+}
+
+static void test_sizes(int n, int kind)
+{
+  int* a = (int*)malloc(sizeof(int) * (n + 1));
+  int* b = (int*)malloc(sizeof(int) * (n + 1));
+  item* it = (item*)malloc(sizeof(item) * (n + 1));
+  item* scratch = (item*)malloc(sizeof(item) * (n + 1));
+  SLOWARR_SZT lb;
+  int i, probe;
+
+  for (i = 0; i < n; i++) {
+    a[i] = b[i] = gen(kind, i, n);
+    it[i].key = a[i];
+    it[i].order = i;
+  }
+
+  F(SLOWARR__SO, int_asc, sort)(a, n);
+  qsort(b, n, sizeof(int), cmp_int);
+  for (i = 0; i < n; i++)
+    if (a[i] != b[i]) {
+      printf("sort: n %d kind %d differs at %d\n", n, kind, i);
+      failed = 1;
+      break;
+    }
+
+  F(SLOWARR__SO, item_key, radixSort)(it, scratch, n);
+  for (i = 0; i < n; i++)
+    if (it[i].key != b[i] ||
+        (i && it[i].key == it[i - 1].key && it[i].order < it[i - 1].order)) {
+      printf("radixSort: n %d kind %d wrong at %d\n", n, kind, i);
+      failed = 1;
+      break;
+    }
+
+  F(SLOWARR__SO, item_key, sort)(it, n);
+  for (i = 1; i < n; i++)
+    if (it[i].key < it[i - 1].key) {
+      printf("sort items: n %d kind %d wrong at %d\n", n, kind, i);
+      failed = 1;
+      break;
+    }
+
+  for (i = 0; i < 50; i++) {
+    probe = n ? a[next_rand() % n] + (i % 3) - 1 : i;
+    lb = F(SLOWARR__SO, int_asc, lowerBound)(a, n, probe);
+    if (lb > (SLOWARR_SZT)n || (lb < (SLOWARR_SZT)n && a[lb] < probe) ||
+        (lb > 0 && a[lb - 1] >= probe)) {
+      printf("lowerBound: n %d probe %d gave %lu\n", n, probe,
+             (unsigned long)lb);
+      failed = 1;
+      break;
+    }
+  }
+
+  free(a);
+  free(b);
+  free(it);
+  free(scratch);
+}
+
+int main()
+{
+  static int const sizes[] = {0, 1, 2, 3, 15, 16, 17, 100, 1000, 100000};
+  unsigned s;
+  int kind;
+
+  for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    for (kind = 0; kind < 6; kind++)
+      test_sizes(sizes[s], kind);
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
@@ -0,0 +1,56 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "slowlibs/systemrand.h"
+
+static int failed = 0;
+
+static void test(unsigned long length, slowcrypt_systemrand_flags flags)
+{
+  unsigned char* buf = malloc(length + 1);
+  unsigned long i, zeros = 0;
+  int rc;
+
+  memset(buf, 0, length + 1);
+  buf[length] = 0xA5;
+  rc = slowcrypt_systemrand(buf, length, flags);
+  if (rc) {
+    printf("%lu bytes, flags %d: rc %d\n", length, (int)flags, rc);
+    failed = 1;
+  }
+  if (buf[length] != 0xA5) {
+    printf("%lu bytes, flags %d: wrote past the end\n", length, (int)flags);
+    failed = 1;
+  }
+
+  /* the whole buffer has to be filled, not just the first chunk */
+  for (i = 0; i < length; i++)
+    zeros += !buf[i];
+  if (length >= 64 && zeros > length / 32) {
+    printf("%lu bytes, flags %d: %lu zero bytes\n", length, (int)flags, zeros);
+    failed = 1;
+  }
+  if (length >= 16 && length <= 64 && zeros == length) {
+    printf("%lu bytes, flags %d: all zero\n", length, (int)flags);
+    failed = 1;
+  }
+  free(buf);
+}
+
+int main()
+{
+  static unsigned long const lengths[] = {0,   1,    16,   255,
+                                          256, 257,  4096, 1 << 20};
+  slowcrypt_systemrand_flags const bail = SLOWCRYPT_SYSTEMRAND__BAIL_IF_INSECURE;
+  unsigned i, j;
+
+  for (j = 0; j < 2; j++)
+    for (i = 0; i < sizeof(lengths) / sizeof(lengths[0]); i++) {
+      test(lengths[i], bail);
+      test(lengths[i], bail | SLOWCRYPT_SYSTEMRAND__INSECURE_NON_BLOCKING);
+    }
+
+  if (!failed)
+    printf("all passed\n");
+  return failed;
+}
@@ -0,0 +1,48 @@
+#include <stdio.h>
+#include "slowlibs/systemrand.h"
+
+#if defined(unix) || defined(__unix__) || defined(__APPLE__)
+#include <poll.h>
+#define HAVE_POLL
+#endif
+
+int main()
+{
+  unsigned char buf[64];
+  slowlibs_io_status status;
+  int fd;
+
+  /* the pool is long initialized when tests run */
+  status = slowcrypt_systemrand_ready();
+  if (status != SLOWLIBS_IO_OK) {
+    printf("ready: %d\n", (int)status);
+    return 1;
+  }
+
+  status = slowcrypt_systemrand_try(buf, sizeof(buf));
+  if (status != SLOWLIBS_IO_OK) {
+    printf("try: %d\n", (int)status);
+    return 1;
+  }
+
+  fd = slowcrypt_systemrand_poll_fd();
+#ifdef HAVE_POLL
+  {
+    struct pollfd p;
+    p.fd = fd;
+    p.events = POLLIN;
+    p.revents = 0;
+    if (fd < 0 || poll(&p, 1, 1000) != 1 || !(p.revents & POLLIN)) {
+      printf("poll_fd %d: not readable\n", fd);
+      return 1;
+    }
+  }
+#endif
+  if (fd != slowcrypt_systemrand_poll_fd()) {
+    printf("poll_fd: changed\n");
+    return 1;
+  }
+
+  printf("all passed\n");
+  return 0;
+}
@@ -0,0 +1,2 @@
+#define SLOWCRYPT_GF25519_USE_32BIT
+#include "rfc7748.c"